@@ -2,151 +2,175 @@
 #include <iostream>
 #include <optional>
 #include <algorithm>
-#include <sstream>
 #include <fstream>
-#include <cctype>
 #include <limits>
+#include <cstring>
+#include <string_view>
+#include <atomic>
+#include <bitset>
 
 #include "CDataframe.h"
+#include "MappedFile.h"
+#include "CsvParsing.h"
+#include "ThreadPool.h"
 
-// ----------------- CSV helpers (minimum) -----------------
+// ----------------- Memory-mapped CSV helpers -----------------
 
-static std::vector<std::string> splitCsvLine(const std::string& line)
-{
-    std::vector<std::string> out;
-    std::stringstream ss(line);
-    std::string token;
-    while (std::getline(ss, token, ',')) out.push_back(token);
-    return out;
-}
+// Taille minimale d'une plage confiée à un thread lors d'un chargement parallèle
+static const size_t MIN_CSV_CHUNK = 1 << 20;
 
-static std::string trim(const std::string& s)
+// Parse toutes les lignes de [p, end) dans des colonnes neuves (un fragment)
+static std::vector<Column> parseCsvRange(const char* p, const char* end, const std::vector<ColumnType>& types)
 {
-    size_t a = 0, b = s.size();
-    while (a < b && std::isspace(static_cast<unsigned char>(s[a]))) ++a;
-    while (b > a && std::isspace(static_cast<unsigned char>(s[b-1]))) --b;
-    return s.substr(a, b - a);
-}
+    std::vector<Column> fragment;
+    fragment.reserve(types.size());
+    for (size_t i = 0; i < types.size(); ++i)
+        fragment.emplace_back("col_" + std::to_string(i), types[i]);
+
+    std::vector<Column*> cols;
+    cols.reserve(types.size());
+    for (Column& c : fragment) cols.push_back(&c);
+
+    // un comptage des '\n' suffit pour dimensionner les buffers une seule fois
+    const size_t rows = static_cast<size_t>(std::count(p, end, '\n')) + 1;
+    beginCsvStringColumns(cols);
+    for (Column* c : cols) c->reserve(rows);
+
+    size_t n = 0;
+    while (p < end) {
+        appendCsvLine(nextCsvLine(p, end), types, cols);
+        if (++n == DICTIONARY_SAMPLE_ROWS) settleCsvStringColumns(cols);
+    }
 
-static bool isNullToken(const std::string& raw)
-{
-    const std::string s = trim(raw);
-    return s.empty() || s == "NULL" || s == "null" || s == "NaN";
+    return fragment;
 }
 
-static bool parseInt64(const std::string& raw, long long& out)
+// Découpe [p, end) en au plus `parts` plages qui commencent toutes en début de ligne
+static std::vector<std::pair<const char*, const char*>> splitCsvRanges(const char* p, const char* end, size_t parts)
 {
-    std::string s = trim(raw);
-    if (s.empty()) return false;
-
-    size_t i = 0;
-    if (s[0] == '+' || s[0] == '-') i = 1;
-    if (i >= s.size()) return false;
-
-    for (; i < s.size(); ++i)
-        if (!std::isdigit(static_cast<unsigned char>(s[i])))
-            return false;
-
-    try {
-        size_t idx = 0;
-        out = std::stoll(s, &idx, 10);
-        return idx == s.size();
-    } catch (...) {
-        return false;
+    std::vector<std::pair<const char*, const char*>> ranges;
+    const size_t step = static_cast<size_t>(end - p) / parts;
+
+    const char* begin = p;
+    for (size_t k = 1; k < parts && begin < end; ++k) {
+        const char* target = p + k * step;
+        if (target < begin) continue;
+
+        const char* nl = static_cast<const char*>(std::memchr(target, '\n', static_cast<size_t>(end - target)));
+        const char* cut = nl ? nl + 1 : end;
+        ranges.emplace_back(begin, cut);
+        begin = cut;
     }
-}
-
-static bool parseUInt64(const std::string& raw, unsigned long long& out)
-{
-    std::string s = trim(raw);
-    if (s.empty()) return false;
+    if (begin < end) ranges.emplace_back(begin, end);
 
-    for (char c : s)
-        if (!std::isdigit(static_cast<unsigned char>(c)))
-            return false;
-
-    try {
-        size_t idx = 0;
-        out = std::stoull(s, &idx, 10);
-        return idx == s.size();
-    } catch (...) {
-        return false;
-    }
+    return ranges;
 }
 
-static bool parseDouble(const std::string& raw, double& out)
+static std::unique_ptr<CDataframe> loadFromMappedCSV(
+    const std::string& filename,
+    const std::vector<ColumnType>& types,
+    ThreadPool& pool)
 {
-    std::string s = trim(raw);
-    if (s.empty()) return false;
+    MappedFile file(filename);
 
-    try {
-        size_t idx = 0;
-        out = std::stod(s, &idx);
-        return idx == s.size();
-    } catch (...) {
-        return false;
-    }
-}
+    auto df = std::make_unique<CDataframe>(types);
 
-static ColumnValue parseByType(const std::string& raw, ColumnType t)
-{
-    std::string s = trim(raw);
-    if (isNullToken(s)) return std::monostate{};
+    const char* p = file.data();
+    const char* end = p + file.size();
+    if (p == end) return df;
 
-    try {
-        switch (t) {
-            case ColumnType::NULLVAL:
-                return std::monostate{};
+    std::string_view header = nextCsvLine(p, end);
+    df->setColumnNames(splitCsvLine(header));
 
-            case ColumnType::STRING:
-                return s;
+    // pas la peine de lancer un thread pour moins de MIN_CSV_CHUNK octets
+    const size_t bytes = static_cast<size_t>(end - p);
+    const size_t parts = std::max<size_t>(1, std::min<size_t>(pool.size(), bytes / MIN_CSV_CHUNK));
+    const auto ranges = splitCsvRanges(p, end, parts);
 
-            case ColumnType::DOUBLE:
-                return static_cast<double>(std::stod(s));
+    std::vector<std::vector<Column>> fragments(ranges.size());
+    pool.parallelFor(ranges.size(), [&](size_t k) {
+        fragments[k] = parseCsvRange(ranges[k].first, ranges[k].second, types);
+    });
 
-            case ColumnType::FLOAT:
-                return static_cast<float>(std::stof(s));
+    // recollage des fragments dans l'ordre du fichier
+    for (size_t i = 0; i < types.size(); ++i) {
+        auto col = df->getColumnByIndex(i);
 
-            case ColumnType::INT:
-                return static_cast<int32_t>(std::stol(s));
+        size_t total = 0;
+        for (const auto& fragment : fragments) total += static_cast<size_t>(fragment[i].getSize());
+        col->reserve(total);
 
-            case ColumnType::UINT:
-                return static_cast<uint32_t>(std::stoul(s));
+        for (auto& fragment : fragments) col->appendColumn(std::move(fragment[i]));
+        col->optimizeStringEncoding();
+    }
+
+    return df;
+}
 
-            case ColumnType::SHORT:
-                return static_cast<int16_t>(std::stoi(s));
+// ----------------- Whole-frame scans -----------------
 
-            case ColumnType::USHORT:
-                return static_cast<uint16_t>(std::stoul(s));
+// Lignes par tâche de parcours : une zone des statistiques de colonne (multiple de 64, ne coupe aucun mot de validité)
+static const size_t SCAN_CHUNK_ROWS = ZONE_ROWS;
 
-            case ColumnType::LONG:
-                return static_cast<int64_t>(std::stoll(s));
+// Une tâche = une plage de lignes d'une colonne
+struct ScanTask {
+    const Column* col;
+    size_t begin;
+    size_t end;
+};
 
-            case ColumnType::ULONG:
-                return static_cast<uint64_t>(std::stoull(s));
+static std::vector<ScanTask> makeScanTasks(const std::vector<std::shared_ptr<Column>>& columns,
+                                           const ValidityBitmap* deleted)
+{
+    std::vector<ScanTask> tasks;
+    for (const auto& col : columns) {
+        const size_t rows = static_cast<size_t>(col->getSize());
+        // une colonne indexée répond en O(log n) sur toute sa hauteur : une seule tâche
+        // (sauf s'il y a des lignes supprimées, que l'index ne connaît pas)
+        if (col->checkIndex() == 1 && !deleted) {
+            if (rows > 0) tasks.push_back({col.get(), 0, rows});
+            continue;
+        }
+        for (size_t begin = 0; begin < rows; begin += SCAN_CHUNK_ROWS)
+            tasks.push_back({col.get(), begin, std::min(rows, begin + SCAN_CHUNK_ROWS)});
+    }
+    return tasks;
+}
 
-            case ColumnType::CHAR: {
-                long long v;
-                if (parseInt64(s, v)) return static_cast<int8_t>(v);
-                return s.empty() ? static_cast<int8_t>(0) : static_cast<int8_t>(s[0]);
-            }
+/**
+ * Rebuild the statistics left stale by writes before a parallel scan: the
+ * scans are const and only skip rows on current statistics.
+ */
+static void refreshStatistics(const std::vector<std::shared_ptr<Column>>& columns)
+{
+    for (const auto& col : columns) col->refreshStatistics();
+}
 
-            case ColumnType::UCHAR: {
-                unsigned long long v;
-                if (parseUInt64(s, v)) return static_cast<uint8_t>(v);
-                return s.empty() ? static_cast<uint8_t>(0) : static_cast<uint8_t>(s[0]);
-            }
+/**
+ * Sum `count(column, begin, end)` over every column and row range of the frame.
+ * Tasks run on the shared pool unless the frame is smaller than one chunk; each
+ * task writes its own slot, so the total does not depend on the scheduling.
+ */
+template <typename F>
+static int parallelCount(const std::vector<std::shared_ptr<Column>>& columns, const ValidityBitmap* deleted, F count)
+{
+    const std::vector<ScanTask> tasks = makeScanTasks(columns, deleted);
 
-            case ColumnType::OBJECT:
-                // CSV -> on stocke texte brut dans std::any
-                return std::any(s);
+    size_t cells = 0;
+    for (const auto& t : tasks) cells += t.end - t.begin;
 
-            default:
-                return std::monostate{};
-        }
-    } catch (...) {
-        return std::monostate{};
+    size_t total = 0;
+    if (cells <= SCAN_CHUNK_ROWS) {
+        for (const auto& t : tasks) total += static_cast<size_t>(count(*t.col, t.begin, t.end));
+        return static_cast<int>(total);
     }
+
+    std::vector<size_t> partial(tasks.size(), 0);
+    ThreadPool::shared().parallelFor(tasks.size(), [&](size_t k) {
+        partial[k] = static_cast<size_t>(count(*tasks[k].col, tasks[k].begin, tasks[k].end));
+    });
+    for (size_t c : partial) total += c;
+    return static_cast<int>(total);
 }
 
 // ===== CONSTRUCTORS =====
@@ -154,6 +178,8 @@ static ColumnValue parseByType(const std::string& raw, ColumnType t)
 CDataframe::CDataframe()
 {
     this->columns = std::vector<std::shared_ptr<Column>>();
+    this->deletionMode = RowDeletionMode::ERASE;
+    this->view = false;
 }
 
 CDataframe::CDataframe(const std::vector<ColumnType>& types)
@@ -162,6 +188,8 @@ CDataframe::CDataframe(const std::vector<ColumnType>& types)
         auto col = std::make_shared<Column>("col_" + std::to_string(i), types[i]);
         this->columns.push_back(col);
     }
+    this->deletionMode = RowDeletionMode::ERASE;
+    this->view = false;
 }
 
 CDataframe::CDataframe(const std::vector<Column> &cols)
@@ -170,6 +198,8 @@ CDataframe::CDataframe(const std::vector<Column> &cols)
         auto shared_col = std::make_shared<Column>(col);
         this->columns.push_back(shared_col);
     }
+    this->deletionMode = RowDeletionMode::ERASE;
+    this->view = false;
 }
 
 CDataframe::CDataframe(std::initializer_list<Column> cols)
@@ -177,6 +207,8 @@ CDataframe::CDataframe(std::initializer_list<Column> cols)
     for (const auto& c : cols) {
         this->columns.push_back(std::make_shared<Column>(c));
     }
+    this->deletionMode = RowDeletionMode::ERASE;
+    this->view = false;
 }
 
 CDataframe::~CDataframe() {}
@@ -185,7 +217,9 @@ CDataframe::~CDataframe() {}
 
 void CDataframe::print(std::optional<int> firstRowOpt, std::optional<int> lastRowOpt, const std::vector<Column>* colOpt)
 {
-    const int total = this->sizeBiggestCol();
+    // lignes supprimées (mode TOMBSTONE) : sautées, les autres sont numérotées sans trou
+    const bool ownColumns = colOpt == nullptr;
+    const int total = this->sizeBiggestCol() - (ownColumns ? static_cast<int>(this->getDeletedRowsCount()) : 0);
     const int firstRow = firstRowOpt.has_value() ? std::max(0, total - firstRowOpt.value()) : 0;
     const int lastRow  = lastRowOpt.has_value()  ? std::min(total, lastRowOpt.value())      : total;
 
@@ -201,13 +235,15 @@ void CDataframe::print(std::optional<int> firstRowOpt, std::optional<int> lastRo
     for (const Column& c : cols) std::cout << c.getName() << " ";
     std::cout << "\n\n";
 
-    for (int row = firstRow; row < lastRow; ++row) {
+    size_t stored = ownColumns ? this->storedRow(static_cast<size_t>(firstRow)) : static_cast<size_t>(firstRow);
+    for (int row = firstRow; row < lastRow; ++row, ++stored) {
         if (row >= total) break;
+        if (ownColumns) while (this->isDeleted(stored)) ++stored;
 
         std::cout << "[" << row << "] ";
         for (const Column& c : cols) {
-            auto v = c.getValueAt(row);
-            if (v.has_value()) std::cout << c.valueToString(static_cast<size_t>(row));
+            auto v = c.getValueAt(static_cast<int>(stored));
+            if (v.has_value()) std::cout << c.valueToString(stored);
             else std::cout << "NULL";
             std::cout << " ";
         }
@@ -246,12 +282,14 @@ bool CDataframe::deleteColumn(const std::string& colName)
 
 void CDataframe::setColumnNames(const std::vector<std::string>& names)
 {
+    this->detach();
     for (size_t i = 0; i < names.size() && i < this->columns.size(); ++i)
         this->columns[i]->setName(names[i]);
 }
 
 bool CDataframe::insertColumns(const std::vector<Column*>& cols)
 {
+    this->detach();
     for (const auto& col : cols) {
         if (!col) return false;
         this->columns.push_back(std::make_shared<Column>(*col));
@@ -262,16 +300,48 @@ bool CDataframe::insertColumns(const std::vector<Column*>& cols)
 bool CDataframe::insertColumn(Column* col)
 {
     if (!col) return false;
+    this->detach();
     this->columns.push_back(std::make_shared<Column>(*col));
     return true;
 }
 
 bool CDataframe::insertRows(const std::vector<std::vector<ColumnValue>>& rows)
 {
-    for (const auto& row : rows) {
+    for (const auto& row : rows)
         if (row.size() != this->columns.size()) return false;
-        if (!this->insertRow(row)) return false;
+
+    // chaque colonne lit directement son champ dans les lignes, sans transposition
+    return this->insertStaged([&rows](Column& staged, size_t c) {
+        return staged.insertValuesAuto(rows, c);
+    });
+}
+
+bool CDataframe::insertRowsColumnar(const std::vector<std::vector<ColumnValue>>& batch)
+{
+    if (batch.size() != this->columns.size()) return false;
+    for (const auto& values : batch)
+        if (values.size() != batch.front().size()) return false;
+
+    return this->insertStaged([&batch](Column& staged, size_t c) {
+        return staged.insertValuesAuto(batch[c]);
+    });
+}
+
+template <typename F>
+bool CDataframe::insertStaged(F fill)
+{
+    this->detach();
+
+    // tout est converti à part avant de toucher au dataframe : un échec ne laisse aucune trace
+    std::vector<Column> staged;
+    staged.reserve(this->columns.size());
+    for (size_t c = 0; c < this->columns.size(); ++c) {
+        staged.emplace_back(this->columns[c]->getName(), this->columns[c]->getType());
+        if (!fill(staged.back(), c)) return false;
     }
+
+    for (size_t c = 0; c < this->columns.size(); ++c)
+        this->columns[c]->appendColumn(std::move(staged[c]));
     return true;
 }
 
@@ -279,6 +349,7 @@ bool CDataframe::insertRow(const std::vector<ColumnValue>& values)
 {
     if (values.size() != this->columns.size())
         return false;
+    this->detach();
 
     // tentative d'insertion + rollback si une colonne refuse
     for (size_t i = 0; i < values.size(); ++i) {
@@ -293,15 +364,127 @@ bool CDataframe::insertRow(const std::vector<ColumnValue>& values)
 
 bool CDataframe::deleteRow(const int idx)
 {
+    if (this->deletionMode == RowDeletionMode::TOMBSTONE) {
+        if (idx < 0 || static_cast<size_t>(idx) >= this->getRowsCount()) return false;
+
+        const size_t row = this->storedRow(static_cast<size_t>(idx));
+        this->deletedRows.resize(row + 1);
+        this->deletedRows.set(row, true);
+        this->compactIfNeeded();
+        return true;
+    }
+
+    this->detach();
     if (idx < 0 || idx >= this->sizeBiggestCol()) return false;
 
     for (auto& c : this->columns) c->removeValue(idx);
     return true;
 }
 
+bool CDataframe::deleteRows(const std::vector<size_t>& indices)
+{
+    const size_t live = this->getRowsCount();
+    for (size_t i : indices)
+        if (i >= live) return false;
+
+    std::vector<size_t> wanted = indices;
+    std::sort(wanted.begin(), wanted.end());
+    wanted.erase(std::unique(wanted.begin(), wanted.end()), wanted.end());
+    if (wanted.empty()) return true;
+
+    // un seul passage : la k-ième ligne vivante rencontrée est la ligne k
+    size_t next = 0;
+    size_t liveRow = 0;
+    for (size_t row = 0; next < wanted.size(); ++row) {
+        if (this->isDeleted(row)) continue;
+        if (liveRow++ != wanted[next]) continue;
+
+        this->deletedRows.resize(row + 1);
+        this->deletedRows.set(row, true);
+        next++;
+    }
+
+    if (this->deletionMode == RowDeletionMode::ERASE) this->compact();
+    else this->compactIfNeeded();
+    return true;
+}
+
+void CDataframe::setDeletionMode(RowDeletionMode mode)
+{
+    this->deletionMode = mode;
+    if (mode == RowDeletionMode::ERASE) this->compact();
+}
+
+RowDeletionMode CDataframe::getDeletionMode() const
+{
+    return this->deletionMode;
+}
+
+void CDataframe::compact()
+{
+    // une vue ne touche jamais aux colonnes partagées : elle copie ses lignes à la place
+    if (this->view) return this->detach();
+    if (this->getDeletedRowsCount() == 0) return;
+
+    for (auto& c : this->columns) c->removeRows(this->deletedRows);
+    this->deletedRows = ValidityBitmap();
+}
+
+size_t CDataframe::getDeletedRowsCount() const
+{
+    // bitmap de suppression : ses bits à 1 sont les lignes supprimées
+    return this->deletedRows.size() - this->deletedRows.nullCount();
+}
+
+void CDataframe::compactIfNeeded()
+{
+    const double stored = static_cast<double>(this->storedRowsCount());
+    if (static_cast<double>(this->getDeletedRowsCount()) >= TOMBSTONE_COMPACT_RATIO * stored)
+        this->compact();
+}
+
+size_t CDataframe::storedRowsCount() const
+{
+    if (this->columns.empty()) return 0;
+    return static_cast<size_t>(this->columns[0]->getSize());
+}
+
+bool CDataframe::isDeleted(size_t row) const
+{
+    return row < this->deletedRows.size() && this->deletedRows.test(row);
+}
+
+size_t CDataframe::storedRow(size_t liveRow) const
+{
+    if (this->getDeletedRowsCount() == 0) return liveRow;
+
+    // mot par mot : les bits à 0 du bitmap (et tout ce qui le suit) sont des lignes vivantes
+    const std::vector<uint64_t>& words = this->deletedRows.raw();
+    size_t remaining = liveRow;
+    for (size_t w = 0; w < words.size(); ++w) {
+        uint64_t live = ~words[w];
+        const size_t n = std::bitset<64>(live).count();
+        if (remaining >= n) {
+            remaining -= n;
+            continue;
+        }
+        for (size_t bit = 0; ; ++bit) {
+            if (!((live >> bit) & 1u)) continue;
+            if (remaining-- == 0) return w * 64 + bit;
+        }
+    }
+    return words.size() * 64 + remaining;
+}
+
+const ValidityBitmap* CDataframe::deletedMask() const
+{
+    return this->getDeletedRowsCount() > 0 ? &this->deletedRows : nullptr;
+}
+
 bool CDataframe::renameCol(Column* col, const std::string& newName)
 {
     if (!col || newName.empty()) return false;
+    this->detach();
 
     for (auto& c : this->columns) {
         if (c->getName() == col->getName())
@@ -312,29 +495,244 @@ bool CDataframe::renameCol(Column* col, const std::string& newName)
 
 bool CDataframe::exist(const int val)
 {
-    for (auto& c : this->columns)
-        if (c->occurence(static_cast<int32_t>(val)) > 0)
-            return true;
-    return false;
+    const ColumnValue value = static_cast<int32_t>(val);
+    const ValidityBitmap* deleted = this->deletedMask();
+    refreshStatistics(this->columns);
+
+    // colonnes avec table de hachage : réponse en O(1), avant tout parcours
+    std::vector<std::shared_ptr<Column>> scanned;
+    for (const auto& col : this->columns) {
+        if (!col->hasHashIndex()) {
+            scanned.push_back(col);
+        } else if (!deleted) {
+            if (col->exist(value)) return true;
+        } else {
+            for (size_t row : col->findRows(value))
+                if (!this->isDeleted(row)) return true;
+        }
+    }
+
+    const std::vector<ScanTask> tasks = makeScanTasks(scanned, deleted);
+
+    // dès qu'une tâche trouve la valeur, les suivantes ne font plus rien
+    std::atomic<bool> found(false);
+    ThreadPool::shared().parallelFor(tasks.size(), [&](size_t k) {
+        if (found.load(std::memory_order_relaxed)) return;
+        if (tasks[k].col->occurence(value, tasks[k].begin, tasks[k].end, deleted) > 0)
+            found.store(true, std::memory_order_relaxed);
+    });
+    return found.load();
 }
 
 bool CDataframe::replaceValue(const Column& col, const int index, const int newVal)
 {
+    this->detach();
+    if (this->getDeletedRowsCount() > 0) {
+        if (index < 0 || static_cast<size_t>(index) >= this->getRowsCount()) return false;
+    }
+    const int row = index < 0 ? index : static_cast<int>(this->storedRow(static_cast<size_t>(index)));
+
     for (auto& c : this->columns) {
         if (c->getName() == col.getName())
-            return c->accessReplaceValue(index, static_cast<int32_t>(newVal));
+            return c->accessReplaceValue(row, static_cast<int32_t>(newVal));
     }
     return false;
 }
 
+// ===== FILTERING =====
+
+static const Column* findColumn(const std::vector<std::shared_ptr<Column>>& columns, const std::string& name)
+{
+    for (const auto& col : columns)
+        if (col->getName() == name) return col.get();
+    return nullptr;
+}
+
+// Lignes [0, n) absentes de `rows` (celles au-delà de sa fin comptent comme absentes)
+static ValidityBitmap complement(const ValidityBitmap& rows, size_t n)
+{
+    std::vector<uint64_t> words((n + 63) / 64, ~uint64_t{0});
+    const std::vector<uint64_t>& src = rows.raw();
+    for (size_t w = 0; w < words.size() && w < src.size(); ++w) words[w] = ~src[w];
+
+    ValidityBitmap out;
+    out.assign(words.data(), n);
+    return out;
+}
+
+bool CDataframe::selectStored(const std::vector<ColumnPredicate>& predicates, PredicateCombine combine,
+                              ValidityBitmap& selection) const
+{
+    std::vector<const Column*> tested;
+    for (const auto& p : predicates) {
+        const Column* col = findColumn(this->columns, p.column);
+        if (!col) return false;
+        tested.push_back(col);
+    }
+    const size_t rows = this->storedRowsCount();
+    const bool all = combine == PredicateCombine::AND;
+    const std::vector<uint64_t>& deleted = this->deletedRows.raw();
+    std::vector<uint64_t> words((rows + 63) / 64, 0);
+
+    // un bloc de lignes par tâche : tous les prédicats y passent tant que ses mots sont en cache
+    const size_t chunks = (rows + SCAN_CHUNK_ROWS - 1) / SCAN_CHUNK_ROWS;
+    ThreadPool::shared().parallelFor(chunks, [&](size_t k) {
+        const size_t begin = k * SCAN_CHUNK_ROWS;
+        const size_t end = std::min(rows, begin + SCAN_CHUNK_ROWS);
+        const size_t first = begin / 64;
+        const size_t n = (end - begin + 63) / 64;
+        uint64_t* out = words.data() + first;
+
+        if (all && predicates.empty()) std::fill(out, out + n, ~uint64_t{0});
+
+        std::vector<uint64_t> match;
+        // zones lues telles quelles (const, colonnes partagées) : une colonne aux bornes périmées est parcourue en entier
+        for (size_t p = 0; p < predicates.size(); ++p) {
+            const ColumnPredicate& pred = predicates[p];
+
+            // OU : les bits s'ajoutent directement ; ET : le premier prédicat écrit, les suivants filtrent
+            if (!all || p == 0) {
+                tested[p]->select(pred.op, pred.value, pred.upper, begin, end, out);
+            } else {
+                match.assign(n, 0);
+                tested[p]->select(pred.op, pred.value, pred.upper, begin, end, match.data());
+                for (size_t w = 0; w < n; ++w) out[w] &= match[w];
+            }
+
+            // plus aucune ligne retenue dans ce bloc : les autres prédicats n'y changeront rien
+            if (all && std::all_of(out, out + n, [](uint64_t w) { return w == 0; })) break;
+        }
+
+        for (size_t w = 0; w < n && first + w < deleted.size(); ++w) out[w] &= ~deleted[first + w];
+    });
+
+    selection.assign(words.data(), rows);
+    return true;
+}
+
+bool CDataframe::select(const std::vector<ColumnPredicate>& predicates, PredicateCombine combine,
+                        ValidityBitmap& selection) const
+{
+    ValidityBitmap stored;
+    if (!this->selectStored(predicates, combine, stored)) return false;
+
+    // numérotation des lignes vivantes
+    if (this->getDeletedRowsCount() > 0) stored.removeRows(this->deletedRows);
+    selection = std::move(stored);
+    return true;
+}
+
+std::unique_ptr<CDataframe> CDataframe::filter(const std::vector<ColumnPredicate>& predicates,
+                                               PredicateCombine combine,
+                                               const std::vector<std::string>& columns,
+                                               FilterMode mode) const
+{
+    ValidityBitmap stored;
+    if (!this->selectStored(predicates, combine, stored)) return nullptr;
+    return this->filterStored(stored, columns, mode);
+}
+
+std::unique_ptr<CDataframe> CDataframe::filter(const ValidityBitmap& selection,
+                                               const std::vector<std::string>& columns,
+                                               FilterMode mode) const
+{
+    if (this->getDeletedRowsCount() == 0) return this->filterStored(selection, columns, mode);
+
+    // la ligne vivante k est la k-ième ligne stockée non supprimée
+    const size_t rows = this->storedRowsCount();
+    ValidityBitmap stored;
+    stored.reserve(rows);
+    size_t live = 0;
+    for (size_t row = 0; row < rows; ++row) {
+        if (this->isDeleted(row)) {
+            stored.push_back(false);
+            continue;
+        }
+        stored.push_back(live < selection.size() && selection.test(live));
+        live++;
+    }
+    return this->filterStored(stored, columns, mode);
+}
+
+std::unique_ptr<CDataframe> CDataframe::filterStored(const ValidityBitmap& selection,
+                                                     const std::vector<std::string>& columns,
+                                                     FilterMode mode) const
+{
+    std::vector<std::shared_ptr<Column>> kept;
+    if (columns.empty()) kept = this->columns;
+    for (const auto& name : columns) {
+        auto it = std::find_if(this->columns.begin(), this->columns.end(),
+            [&name](const std::shared_ptr<Column>& col) { return col->getName() == name; });
+        if (it == this->columns.end()) return nullptr;
+        kept.push_back(*it);
+    }
+
+    auto df = std::make_unique<CDataframe>();
+
+    if (mode == FilterMode::VIEW) {
+        df->columns = kept;
+        df->deletedRows = complement(selection, this->storedRowsCount());
+        df->view = true;
+        return df;
+    }
+
+    // seules les lignes retenues des colonnes demandées sont copiées
+    df->columns.resize(kept.size());
+    ThreadPool::shared().parallelFor(kept.size(), [&](size_t c) {
+        df->columns[c] = std::make_shared<Column>(kept[c]->gather(selection));
+    });
+    return df;
+}
+
+std::unique_ptr<CDataframe> CDataframe::gatherStored(const std::vector<uint32_t>& rows,
+                                                     const std::vector<std::string>& columns) const
+{
+    std::vector<const Column*> kept;
+    for (const auto& col : this->columns)
+        if (columns.empty()) kept.push_back(col.get());
+    for (const auto& name : columns) {
+        kept.push_back(findColumn(this->columns, name));
+        if (!kept.back()) return nullptr;
+    }
+
+    // une colonne par tâche : chaque résultat est écrit d'un bout à l'autre
+    auto df = std::make_unique<CDataframe>();
+    df->columns.resize(kept.size());
+    ThreadPool::shared().parallelFor(kept.size(), [&](size_t c) {
+        df->columns[c] = std::make_shared<Column>(kept[c]->gather(rows));
+    });
+    return df;
+}
+
+bool CDataframe::isView() const
+{
+    return this->view;
+}
+
+void CDataframe::detach()
+{
+    if (!this->view) return;
+
+    const ValidityBitmap live = complement(this->deletedRows, this->storedRowsCount());
+    for (auto& col : this->columns) col = std::make_shared<Column>(col->gather(live));
+    this->deletedRows = ValidityBitmap();
+    this->view = false;
+}
+
+// ===== AGGREGATION =====
+
+GroupBy CDataframe::groupBy(const std::vector<std::string>& keys) const
+{
+    return GroupBy(*this, keys);
+}
+
 // ===== STATISTICS & INFO =====
 
 size_t CDataframe::getColumnsCount() const { return this->columns.size(); }
 
 size_t CDataframe::getRowsCount() const
 {
-    if (this->columns.empty()) return 0;
-    return static_cast<size_t>(this->columns[0]->getSize());
+    return this->storedRowsCount() - this->getDeletedRowsCount();
 }
 
 int CDataframe::numberOfRows() { return static_cast<int>(this->getRowsCount()); }
@@ -342,37 +740,71 @@ int CDataframe::numberOfCols() { return static_cast<int>(this->getColumnsCount()
 
 int CDataframe::numberOfCellsEqualTo(int x)
 {
-    int count = 0;
-    for (const auto& col : this->columns)
-        count += col->occurence(static_cast<int32_t>(x));
-    return count;
+    const ColumnValue value = static_cast<int32_t>(x);
+    const ValidityBitmap* deleted = this->deletedMask();
+    refreshStatistics(this->columns);
+    return parallelCount(this->columns, deleted, [&value, deleted](const Column& col, size_t begin, size_t end) {
+        return col.occurence(value, begin, end, deleted);
+    });
 }
 
 int CDataframe::numberOfCellsGreaterThan(int x)
 {
-    int count = 0;
-    for (const auto& col : this->columns)
-        count += col->numberGreaterThan(static_cast<int32_t>(x));
-    return count;
+    const ColumnValue value = static_cast<int32_t>(x);
+    const ValidityBitmap* deleted = this->deletedMask();
+    refreshStatistics(this->columns);
+    return parallelCount(this->columns, deleted, [&value, deleted](const Column& col, size_t begin, size_t end) {
+        return col.numberGreaterThan(value, begin, end, deleted);
+    });
 }
 
 int CDataframe::numberOfCellsLowerThan(int x)
 {
-    int count = 0;
-    for (const auto& col : this->columns)
-        count += col->numberLowerThan(static_cast<int32_t>(x));
-    return count;
+    const ColumnValue value = static_cast<int32_t>(x);
+    const ValidityBitmap* deleted = this->deletedMask();
+    refreshStatistics(this->columns);
+    return parallelCount(this->columns, deleted, [&value, deleted](const Column& col, size_t begin, size_t end) {
+        return col.numberLowerThan(value, begin, end, deleted);
+    });
+}
+
+void CDataframe::setThreadCount(unsigned threads)
+{
+    ThreadPool::setSharedThreadCount(threads);
+}
+
+unsigned CDataframe::getThreadCount()
+{
+    return ThreadPool::getSharedThreadCount();
+}
+
+// Borne de colonne affichée par info(), écrite comme valueToString écrit une cellule
+static std::string boundToString(const std::optional<ColumnValue>& bound)
+{
+    if (!bound) return "-";
+    return std::visit([](const auto& v) -> std::string {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, std::string>) return v;
+        else if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, int8_t>) return std::to_string(static_cast<int>(v));
+        else if constexpr (std::is_arithmetic_v<T>) return std::to_string(v);
+        else return "-";
+    }, *bound);
 }
 
-void CDataframe::info() const
+void CDataframe::info()
 {
     std::cout << "DataFrame Information:\n";
     std::cout << "Rows: " << this->getRowsCount() << "\n";
     std::cout << "Columns: " << this->getColumnsCount() << "\n\n";
     std::cout << "Column Details:\n";
     for (size_t i = 0; i < this->columns.size(); ++i) {
+        const ColumnStats& stats = this->columns[i]->getStatistics();
         std::cout << "[" << i << "] " << this->columns[i]->getName()
-                  << " (size: " << this->columns[i]->getSize() << ")\n";
+                  << " (size: " << this->columns[i]->getSize()
+                  << ", nulls: " << stats.nullCount()
+                  << ", min: " << boundToString(stats.minimum())
+                  << ", max: " << boundToString(stats.maximum())
+                  << ", distinct: ~" << stats.distinctCount() << ")\n";
     }
 }
 
@@ -380,20 +812,31 @@ void CDataframe::info() const
 
 std::unique_ptr<CDataframe> CDataframe::loadFromCSV(
     const std::string& filename,
-    const std::vector<ColumnType>& types)
+    const std::vector<ColumnType>& types,
+    CSVReadMode mode)
 {
+    if (mode == CSVReadMode::MMAP)
+        return loadFromCSVParallel(filename, types, 1);
+    if (mode == CSVReadMode::PARALLEL)
+        return loadFromCSVParallel(filename, types);
+
     std::ifstream file(filename);
     if (!file.is_open())
         throw std::runtime_error("Cannot open file: " + filename);
 
     auto df = std::make_unique<CDataframe>(types);
 
+    std::vector<Column*> cols;
+    for (size_t i = 0; i < types.size(); ++i) cols.push_back(df->getColumnByIndex(i).get());
+    beginCsvStringColumns(cols);
+
     std::string line;
     if (std::getline(file, line)) {
         auto headers = splitCsvLine(line);
         df->setColumnNames(headers);
     }
 
+    size_t n = 0;
     while (std::getline(file, line)) {
         auto cells = splitCsvLine(line);
 
@@ -401,17 +844,30 @@ std::unique_ptr<CDataframe> CDataframe::loadFromCSV(
         values.reserve(types.size());
 
         for (size_t i = 0; i < types.size(); ++i) {
-            std::string cell = (i < cells.size()) ? cells[i] : "";
+            std::string_view cell = (i < cells.size()) ? std::string_view(cells[i]) : std::string_view();
             values.push_back(parseByType(cell, types[i]));
         }
 
         df->insertRow(values);
+        if (++n == DICTIONARY_SAMPLE_ROWS) settleCsvStringColumns(cols);
     }
 
+    settleCsvStringColumns(cols);
     return df;
 }
 
-std::unique_ptr<CDataframe> CDataframe::loadFromCSVAuto(const std::string& filename)
+std::unique_ptr<CDataframe> CDataframe::loadFromCSVParallel(
+    const std::string& filename,
+    const std::vector<ColumnType>& types,
+    unsigned threads)
+{
+    if (threads == 0) return loadFromMappedCSV(filename, types, ThreadPool::shared());
+
+    ThreadPool pool(threads);
+    return loadFromMappedCSV(filename, types, pool);
+}
+
+std::unique_ptr<CDataframe> CDataframe::loadFromCSVAuto(const std::string& filename, CSVReadMode mode)
 {
     std::ifstream file(filename);
     if (!file.is_open())
@@ -441,7 +897,7 @@ std::unique_ptr<CDataframe> CDataframe::loadFromCSVAuto(const std::string& filen
         auto cells = splitCsvLine(line);
 
         for (size_t c = 0; c < ncols; ++c) {
-            std::string s = (c < cells.size()) ? trim(cells[c]) : "";
+            std::string_view s = (c < cells.size()) ? trimView(cells[c]) : std::string_view();
             if (isNullToken(s)) continue;
 
             double d = 0.0;
@@ -499,7 +955,7 @@ std::unique_ptr<CDataframe> CDataframe::loadFromCSVAuto(const std::string& filen
         }
     }
 
-    return loadFromCSV(filename, types);
+    return loadFromCSV(filename, types, mode);
 }
 
 void CDataframe::saveToCSV(const std::string& filename) const
@@ -514,11 +970,11 @@ void CDataframe::saveToCSV(const std::string& filename) const
     }
     file << "\n";
 
-    for (size_t row = 0; row < this->getRowsCount(); ++row) {
+    for (size_t row = 0; row < this->storedRowsCount(); ++row) {
+        if (this->isDeleted(row)) continue;
+
         for (size_t col = 0; col < this->columns.size(); ++col) {
-            auto val = this->columns[col]->getValueAt(static_cast<int>(row));
-            if (val.has_value()) file << this->columns[col]->valueToString(row);
-            else file << "NULL";
+            this->columns[col]->writeValue(file, row);
 
             if (col + 1 < this->columns.size()) file << ",";
         }
@@ -526,6 +982,111 @@ void CDataframe::saveToCSV(const std::string& filename) const
     }
 }
 
+// ===== BINARY METHODS =====
+
+static const char BINARY_MAGIC[8] = {'C', 'D', 'F', 'R', 'A', 'M', 'E', '\0'};
+static const uint32_t BINARY_VERSION = 1;
+
+template <typename T>
+static void writePod(std::ofstream& out, const T& v)
+{
+    out.write(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+template <typename T>
+static bool readPod(const char*& p, const char* end, T& v)
+{
+    if (static_cast<size_t>(end - p) < sizeof(T)) return false;
+    std::memcpy(&v, p, sizeof(T));
+    p += sizeof(T);
+    return true;
+}
+
+void CDataframe::saveToBinary(const std::string& filename) const
+{
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("Cannot create file: " + filename);
+
+    const uint64_t rows = this->getRowsCount();
+
+    file.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    writePod(file, BINARY_VERSION);
+    writePod(file, static_cast<uint32_t>(this->columns.size()));
+    writePod(file, rows);
+
+    size_t headerSize = sizeof(BINARY_MAGIC) + 2 * sizeof(uint32_t) + sizeof(uint64_t);
+    for (const auto& col : this->columns) {
+        const std::string name = col->getName();
+        writePod(file, static_cast<uint32_t>(col->getType()));
+        writePod(file, static_cast<uint32_t>(name.size()));
+        file.write(name.data(), static_cast<std::streamsize>(name.size()));
+        headerSize += 2 * sizeof(uint32_t) + name.size();
+    }
+
+    // les sections de colonnes commencent sur une frontière de 8 octets
+    static const char zeros[8] = {0};
+    file.write(zeros, static_cast<std::streamsize>(((headerSize + 7) & ~size_t{7}) - headerSize));
+
+    for (const auto& col : this->columns) {
+        if (static_cast<size_t>(col->getSize()) != this->storedRowsCount())
+            throw std::runtime_error("Columns of different sizes cannot be saved: " + col->getName());
+
+        // lignes supprimées non compactées : on écrit une copie compactée de la colonne
+        if (this->getDeletedRowsCount() > 0) {
+            Column kept = *col;
+            kept.removeRows(this->deletedRows);
+            kept.writeBinary(file);
+        } else {
+            col->writeBinary(file);
+        }
+    }
+
+    if (!file)
+        throw std::runtime_error("Cannot write file: " + filename);
+}
+
+std::unique_ptr<CDataframe> CDataframe::loadFromBinary(const std::string& filename)
+{
+    MappedFile file(filename);
+
+    const char* begin = file.data();
+    const char* p = begin;
+    const char* end = begin + file.size();
+    const std::runtime_error corrupted("Invalid binary dataframe: " + filename);
+
+    if (file.size() < sizeof(BINARY_MAGIC) || std::memcmp(p, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0)
+        throw corrupted;
+    p += sizeof(BINARY_MAGIC);
+
+    uint32_t version = 0, ncols = 0;
+    uint64_t rows = 0;
+    if (!readPod(p, end, version) || version != BINARY_VERSION) throw corrupted;
+    if (!readPod(p, end, ncols) || !readPod(p, end, rows)) throw corrupted;
+
+    auto df = std::make_unique<CDataframe>();
+
+    for (uint32_t i = 0; i < ncols; ++i) {
+        uint32_t type = 0, len = 0;
+        if (!readPod(p, end, type) || !readPod(p, end, len)) throw corrupted;
+        if (type < static_cast<uint32_t>(ColumnType::NULLVAL) || type > static_cast<uint32_t>(ColumnType::OBJECT)) throw corrupted;
+        if (static_cast<size_t>(end - p) < len) throw corrupted;
+
+        df->columns.push_back(std::make_shared<Column>(std::string(p, len), static_cast<ColumnType>(type)));
+        p += len;
+    }
+
+    const size_t offset = static_cast<size_t>(p - begin);
+    p = begin + ((offset + 7) & ~size_t{7});
+    if (p > end) throw corrupted;
+
+    for (auto& col : df->columns)
+        if (!col->readBinary(p, end, static_cast<size_t>(rows)))
+            throw corrupted;
+
+    return df;
+}
+
 // ===== HELPER =====
 
 int CDataframe::sizeBiggestCol()
@@ -7,6 +7,102 @@
 #include <fstream>
 
 #include "../Column/Column.h"
+#include "GroupBy.h"
+
+class LazyFrame;
+
+/**
+ * @enum CSVReadMode
+ * @brief Strategy used by CDataframe::loadFromCSV to read the file.
+ */
+enum class CSVReadMode {
+    STREAM, /**< Line by line through std::ifstream / std::getline */
+    MMAP,    /**< Memory-mapped file, fields tokenized as string_view without per-line allocation */
+    PARALLEL /**< Memory-mapped file split in newline-aligned chunks parsed on all cores */
+};
+
+/**
+ * @enum RowDeletionMode
+ * @brief How CDataframe::deleteRow removes a row.
+ */
+enum class RowDeletionMode {
+    ERASE,    /**< The row is removed from every column at once */
+    TOMBSTONE /**< The row is only marked as deleted; compact() removes the marked rows in one pass */
+};
+
+/**
+ * @brief In TOMBSTONE mode, the frame is compacted once this fraction of its rows is deleted
+ */
+const double TOMBSTONE_COMPACT_RATIO = 0.25;
+
+/**
+ * @struct ColumnPredicate
+ * @brief Test of one column, as used by CDataframe::select and CDataframe::filter.
+ *
+ * See Column::select for the meaning of each PredicateOp.
+ */
+struct ColumnPredicate {
+    std::string column; /**< Name of the tested column */
+    PredicateOp op;
+    ColumnValue value;  /**< Compared value (lower bound for RANGE) */
+    ColumnValue upper;  /**< Upper bound (excluded) for RANGE */
+
+    static ColumnPredicate equal(const std::string& column, const ColumnValue& value) { return {column, PredicateOp::EQUAL, value, {}}; }
+    static ColumnPredicate lower(const std::string& column, const ColumnValue& value) { return {column, PredicateOp::LOWER, value, {}}; }
+    static ColumnPredicate greater(const std::string& column, const ColumnValue& value) { return {column, PredicateOp::GREATER, value, {}}; }
+    static ColumnPredicate range(const std::string& column, const ColumnValue& lo, const ColumnValue& hi) { return {column, PredicateOp::RANGE, lo, hi}; }
+    static ColumnPredicate isNull(const std::string& column) { return {column, PredicateOp::IS_NULL, {}, {}}; }
+    static ColumnPredicate notNull(const std::string& column) { return {column, PredicateOp::NOT_NULL, {}, {}}; }
+};
+
+/**
+ * @struct SortKey
+ * @brief One key of CDataframe::sortBy: a column and a direction.
+ */
+struct SortKey {
+    std::string column; /**< Name of the sorted column */
+    bool ascending;
+
+    static SortKey asc(const std::string& column) { return {column, true}; }
+    static SortKey desc(const std::string& column) { return {column, false}; }
+};
+
+/**
+ * @enum PredicateCombine
+ * @brief How the predicates given to CDataframe::select / filter are combined.
+ */
+enum class PredicateCombine {
+    AND, /**< A row is kept if it satisfies every predicate (all rows if there is none) */
+    OR   /**< A row is kept if it satisfies at least one predicate (none if there is none) */
+};
+
+/**
+ * @enum FilterMode
+ * @brief What CDataframe::filter returns.
+ */
+enum class FilterMode {
+    COPY, /**< A new frame holding copies of the selected rows */
+    VIEW  /**< A view sharing the columns of the frame, without copying any value */
+};
+
+/**
+ * @enum JoinKind
+ * @brief Rows returned by CDataframe::join.
+ */
+enum class JoinKind {
+    INNER, /**< One row per pair of a left row and a right row with equal keys */
+    LEFT,  /**< As INNER, plus every left row without a match, its right columns NULL */
+    SEMI   /**< Each left row having at least one match, once, with the left columns only */
+};
+
+/**
+ * @enum JoinMode
+ * @brief How CDataframe::join spreads the work.
+ */
+enum class JoinMode {
+    SEQUENTIAL, /**< Everything on the calling thread */
+    PARALLEL    /**< Build table split into partitions filled by their own thread, probe rows split in ranges */
+};
 
 /**
  * @class CDataframe
@@ -24,6 +120,9 @@
  */
 class CDataframe
 {
+    friend class GroupBy;
+    friend class LazyFrame;
+
 private:
     /**
      * @brief Container of columns composing the dataframe.
@@ -32,6 +131,92 @@ private:
      */
     std::vector<std::shared_ptr<Column>> columns;
 
+    /**
+     * @brief Rows deleted but still stored in the columns (bit set = deleted).
+     *
+     * Shared by all columns; rows past its end are live. Counts, exist,
+     * display and saves skip the rows set here, and row indices given to
+     * the frame count live rows only.
+     */
+    ValidityBitmap deletedRows;
+
+    RowDeletionMode deletionMode;
+
+    /**
+     * @brief true for a frame returned by filter in FilterMode::VIEW.
+     *
+     * A view shares its columns with the frame it comes from and hides the
+     * rows that were not selected through deletedRows. It copies its rows
+     * into columns of its own (see detach) before any change.
+     */
+    bool view;
+
+    /**
+     * @brief Number of rows stored in the columns, deleted ones included.
+     */
+    size_t storedRowsCount() const;
+
+    /**
+     * @brief true if a stored row is marked as deleted.
+     */
+    bool isDeleted(size_t row) const;
+
+    /**
+     * @brief Stored position of the live row of a given index.
+     */
+    size_t storedRow(size_t liveRow) const;
+
+    /**
+     * @brief Bitmap to pass to the column scans (nullptr when no row is deleted).
+     */
+    const ValidityBitmap* deletedMask() const;
+
+    /**
+     * @brief Compact the frame if the deleted rows cross TOMBSTONE_COMPACT_RATIO.
+     */
+    void compactIfNeeded();
+
+    /**
+     * @brief Give a view columns of its own, holding only its rows (no-op for a frame that is not a view).
+     */
+    void detach();
+
+    /**
+     * @brief Stored rows matching the predicates (deleted rows excluded), see select.
+     * @return false if a predicate names an unknown column
+     */
+    bool selectStored(const std::vector<ColumnPredicate>& predicates, PredicateCombine combine,
+                      ValidityBitmap& selection) const;
+
+    /**
+     * @brief filter on a selection of stored rows.
+     */
+    std::unique_ptr<CDataframe> filterStored(const ValidityBitmap& selection,
+                                             const std::vector<std::string>& columns,
+                                             FilterMode mode) const;
+
+    /**
+     * @brief Stored rows (deleted ones excluded) in the order of a set of sort keys, see sortPermutation.
+     * @param selection Stored rows to sort (nullptr = every live row).
+     * @return false if a key names an unknown or OBJECT column
+     */
+    bool sortStored(const std::vector<SortKey>& keys, std::vector<uint32_t>& order,
+                    const ValidityBitmap* selection = nullptr) const;
+
+    /**
+     * @brief New frame holding the given stored rows, in that order (one column per worker).
+     * @return nullptr if a requested column does not exist
+     */
+    std::unique_ptr<CDataframe> gatherStored(const std::vector<uint32_t>& rows,
+                                             const std::vector<std::string>& columns) const;
+
+    /**
+     * @brief Fill one staging column per column with `fill(staged, index)`,
+     *        then append them all, or nothing if one fill fails.
+     */
+    template <typename F>
+    bool insertStaged(F fill);
+
     // ===== DISPLAY =====
 
     /**
@@ -156,13 +341,28 @@ public:
     /**
      * @brief Insert multiple rows into the dataframe.
      *
-     * Each row is represented as a vector of ColumnValue.
+     * Each row is represented as a vector of ColumnValue. The rows are
+     * regrouped by column and go through insertRowsColumnar, so the batch is
+     * inserted entirely or not at all.
      *
      * @param rows Vector of rows.
-     * @return true if insertion succeeded, false otherwise.
+     * @return true if insertion succeeded, false otherwise (dataframe unchanged).
      */
     bool insertRows(const std::vector<std::vector<ColumnValue>>& rows);
 
+    /**
+     * @brief Insert a batch of rows given column by column.
+     *
+     * Each column's values are converted like Column::insertValueAuto in one
+     * typed loop (see Column::insertValuesAuto), into a staging column with its
+     * capacity reserved once; the staged columns are appended only when every
+     * column converted successfully, so the batch is atomic.
+     *
+     * @param batch One vector of values per column, all of the same length.
+     * @return true if insertion succeeded, false otherwise (dataframe unchanged).
+     */
+    bool insertRowsColumnar(const std::vector<std::vector<ColumnValue>>& batch);
+
     /**
      * @brief Insert a single row into the dataframe.
      *
@@ -174,11 +374,52 @@ public:
     /**
      * @brief Delete a row by index.
      *
+     * In ERASE mode the row is removed from every column; in TOMBSTONE mode
+     * it is only marked as deleted (see setDeletionMode).
+     *
      * @param idx Zero-based row index.
      * @return true if deletion succeeded, false otherwise.
      */
     bool deleteRow(const int idx);
 
+    /**
+     * @brief Delete several rows at once.
+     *
+     * The rows are marked in the deletion bitmap, then removed from every
+     * column in a single pass in ERASE mode (or in TOMBSTONE mode once
+     * TOMBSTONE_COMPACT_RATIO is crossed), instead of one memmove per row.
+     *
+     * @param indices Zero-based row indices, all relative to the frame before
+     *                the call; duplicates are ignored.
+     * @return true if deletion succeeded, false (nothing deleted) if an index is out of range.
+     */
+    bool deleteRows(const std::vector<size_t>& indices);
+
+    /**
+     * @brief Choose how deleteRow removes rows (ERASE by default).
+     *
+     * Switching back to ERASE compacts the frame.
+     */
+    void setDeletionMode(RowDeletionMode mode);
+
+    /**
+     * @brief Current row deletion mode.
+     */
+    RowDeletionMode getDeletionMode() const;
+
+    /**
+     * @brief Remove the rows marked as deleted from every column, in one linear pass.
+     *
+     * Columns obtained through getColumnByIndex / getColumnByName still hold
+     * the deleted rows until this is called.
+     */
+    void compact();
+
+    /**
+     * @brief Number of rows marked as deleted and not compacted yet.
+     */
+    size_t getDeletedRowsCount() const;
+
     /**
      * @brief Rename a column.
      *
@@ -191,6 +432,10 @@ public:
     /**
      * @brief Check whether a value exists somewhere in the dataframe.
      *
+     * Columns with a hash index are looked up first; the other columns and row
+     * ranges are scanned in parallel, and once a match is found the remaining
+     * ranges are skipped.
+     *
      * @param val Value to search.
      * @return true if found, false otherwise.
      */
@@ -216,7 +461,7 @@ public:
 
     /**
      * @brief Get number of rows.
-     * @return Number of rows.
+     * @return Number of rows (rows marked as deleted excluded).
      */
     size_t getRowsCount() const;
 
@@ -235,6 +480,9 @@ public:
     /**
      * @brief Count cells equal to a given integer.
      *
+     * Like the two other counts, it runs on the shared worker pool
+     * (see setThreadCount) for frames larger than one scan chunk.
+     *
      * @param x Value to compare.
      * @return Number of matching cells.
      */
@@ -257,9 +505,196 @@ public:
     int numberOfCellsLowerThan(int x);
 
     /**
-     * @brief Print dataframe information (implementation-defined).
+     * @brief Print dataframe information: rows, columns, and per column its
+     *        size, NULL count, smallest / largest value and estimated number
+     *        of distinct values (see Column::getStatistics).
+     *
+     * Not const: the statistics of every column are refreshed first,
+     * distinct sketch included (the columns may be shared with views).
+     */
+    void info();
+
+    // ===== FILTERING =====
+
+    /**
+     * @brief Rows satisfying a set of predicates, as a selection bitmap.
+     *
+     * Each predicate is evaluated on its column into a bitmap of matching
+     * rows (64 rows per word, see Column::select), and the bitmaps are
+     * combined word by word. The frame is processed in chunks of rows on
+     * the shared worker pool, every chunk running all the predicates while
+     * its bitmap words are still in cache.
+     *
+     * @param predicates Tests to apply.
+     * @param combine How to combine them.
+     * @param selection Receives one bit per live row (bit set = row selected).
+     * @return false if a predicate names an unknown column (selection unchanged).
+     */
+    bool select(const std::vector<ColumnPredicate>& predicates, PredicateCombine combine,
+                ValidityBitmap& selection) const;
+
+    /**
+     * @brief New frame holding the rows that satisfy a set of predicates.
+     *
+     * The predicates only read their own columns; the other columns are not
+     * touched until the selection is known, then only the selected rows of
+     * the requested columns are gathered (one column per worker).
+     *
+     * In FilterMode::VIEW nothing is copied: the result shares the columns of
+     * this frame and skips the other rows like deleted rows. Values replaced
+     * in this frame show through the view; adding, removing or compacting rows
+     * here invalidates it. Modifying the view first copies its rows into
+     * columns of its own, so this frame is never changed through a view.
+     *
+     * @param predicates Tests to apply.
+     * @param combine How to combine them.
+     * @param columns Names of the columns to keep, in order (empty = all columns).
+     * @param mode Copy or view.
+     * @return The filtered frame, or nullptr if a predicate or a requested column names an unknown column.
+     */
+    std::unique_ptr<CDataframe> filter(const std::vector<ColumnPredicate>& predicates,
+                                       PredicateCombine combine = PredicateCombine::AND,
+                                       const std::vector<std::string>& columns = {},
+                                       FilterMode mode = FilterMode::COPY) const;
+
+    /**
+     * @brief New frame holding the rows set in a selection (e.g. selections from select combined by hand).
+     *
+     * @param selection One bit per live row; rows past its end are not selected.
+     * @param columns Names of the columns to keep, in order (empty = all columns).
+     * @param mode Copy or view.
+     * @return The filtered frame, or nullptr if a requested column does not exist.
      */
-    void info() const;
+    std::unique_ptr<CDataframe> filter(const ValidityBitmap& selection,
+                                       const std::vector<std::string>& columns = {},
+                                       FilterMode mode = FilterMode::COPY) const;
+
+    /**
+     * @brief true if the frame is a view returned by filter (and not modified since).
+     */
+    bool isView() const;
+
+    // ===== SORTING =====
+
+    /**
+     * @brief Row permutation ordering the frame by one or more key columns.
+     *
+     * Every row gets a normalized binary key: for each sort key a NULL byte
+     * if the column has NULLs (NULLs last when ascending, first when
+     * descending, as in Column::sort), then the value as big-endian bytes
+     * whose unsigned order is the column order (radixKey for numbers, rank
+     * of the string among the distinct strings of the column), inverted when
+     * descending. Keys compare with memcmp, equal keys by row number (the
+     * sort is stable). The first 16 bytes are held next to the row number,
+     * so a key that fits in them is sorted by an LSD radix sort and a longer
+     * one by comparisons; the rows are sorted in chunks on the shared worker
+     * pool, then merged.
+     *
+     * The permutation can be applied to this frame with take, any number of
+     * times and to any subset of its columns.
+     *
+     * @param keys Sort keys, most significant first.
+     * @param rows Receives the live row numbers in sorted order.
+     * @return false if a key names an unknown column or an OBJECT column (rows unchanged).
+     */
+    bool sortPermutation(const std::vector<SortKey>& keys, std::vector<size_t>& rows) const;
+
+    /**
+     * @brief New frame holding the rows sorted by one or more key columns (see sortPermutation).
+     *
+     * The permutation is computed on the key columns only, then applied to
+     * each requested column in a single gather.
+     *
+     * @param keys Sort keys, most significant first, e.g. `{SortKey::asc("country"), SortKey::desc("amount")}`.
+     * @param columns Names of the columns to keep, in order (empty = all columns).
+     * @return The sorted frame, or nullptr if a key or a requested column is unknown, or a key is an OBJECT column.
+     */
+    std::unique_ptr<CDataframe> sortBy(const std::vector<SortKey>& keys,
+                                       const std::vector<std::string>& columns = {}) const;
+
+    /**
+     * @brief New frame holding the given live rows, in the given order (rows may repeat).
+     *
+     * @param rows Live row numbers, e.g. a permutation from sortPermutation.
+     * @param columns Names of the columns to keep, in order (empty = all columns).
+     * @return The new frame, or nullptr if a row is out of range or a requested column does not exist.
+     */
+    std::unique_ptr<CDataframe> take(const std::vector<size_t>& rows,
+                                     const std::vector<std::string>& columns = {}) const;
+
+    // ===== AGGREGATION =====
+
+    /**
+     * @brief Group the rows by the values of one or more key columns.
+     *
+     * Nothing is computed until GroupBy::agg is called, e.g.
+     * `df.groupBy({"city"}).agg({Aggregation::mean("temperature"), Aggregation::count()})`.
+     *
+     * @param keys Names of the key columns (none = a single group holding every row).
+     * @return The grouping; this frame must outlive it and stay unchanged until agg.
+     */
+    GroupBy groupBy(const std::vector<std::string>& keys) const;
+
+    // ===== LAZY QUERIES =====
+
+    /**
+     * @brief Start a query plan on this frame (declared in LazyFrame.h).
+     *
+     * Steps are only recorded, then run together by LazyFrame::collect, e.g.
+     * `df.lazy().filter({ColumnPredicate::equal("year", 2024)}).aggregate({"city"}, {Aggregation::count()}).collect()`.
+     *
+     * @return An empty plan; this frame must outlive it and stay unchanged until collect.
+     */
+    LazyFrame lazy() const;
+
+    // ===== JOINS =====
+
+    /**
+     * @brief Hash join of this frame (left) with another frame (right) on one key column each.
+     *
+     * A hash table of the keys is built on the side with fewer rows, then
+     * the rows of the other side look their key up in it. The probe only
+     * produces pairs of row numbers; the columns are gathered once all the
+     * pairs are known, one column per worker. In JoinMode::PARALLEL the build
+     * table is split into partitions by key hash, each filled by its own
+     * thread, and the probe rows are split in ranges.
+     *
+     * Keys compare by value: numbers whatever their types (3 == 3.0), strings
+     * with strings. NULL keys match nothing; NaN matches NaN. Deleted rows are
+     * skipped. Rows come out in the order of the left rows, the matches of a
+     * left row in the order of the right rows, whichever side is built.
+     *
+     * @param other Right frame.
+     * @param leftKey Key column of this frame.
+     * @param rightKey Key column of the right frame.
+     * @param kind INNER, LEFT or SEMI.
+     * @param mode Sequential or parallel (same result).
+     * @return All the left columns, then (except for SEMI) the right columns
+     *         but the right key, suffixed with "_right" when the name is
+     *         taken; nullptr if a key column does not exist or the key types
+     *         cannot be compared (a string with a number, OBJECT).
+     */
+    std::unique_ptr<CDataframe> join(const CDataframe& other, const std::string& leftKey,
+                                     const std::string& rightKey, JoinKind kind = JoinKind::INNER,
+                                     JoinMode mode = JoinMode::PARALLEL) const;
+
+    // ===== PARALLELISM =====
+
+    /**
+     * @brief Set the number of threads used by whole-frame operations.
+     *
+     * Counts, exist and the parallel CSV loader share one worker pool; large
+     * columns are split into row ranges so that a frame with a single column
+     * also uses every thread.
+     *
+     * @param threads Number of threads (0 = one per hardware thread, the default).
+     */
+    static void setThreadCount(unsigned threads);
+
+    /**
+     * @brief Number of threads used by whole-frame operations.
+     */
+    static unsigned getThreadCount();
 
     // ===== CSV METHODS =====
 
@@ -268,20 +703,44 @@ public:
      *
      * @param filename Path to the CSV file.
      * @param types Column types in order.
+     * @param mode Reading strategy (stream by default, or memory-mapped).
      * @return Unique pointer owning the created dataframe.
      */
     static std::unique_ptr<CDataframe> loadFromCSV(
         const std::string& filename,
-        const std::vector<ColumnType>& types
+        const std::vector<ColumnType>& types,
+        CSVReadMode mode = CSVReadMode::STREAM
+    );
+
+    /**
+     * @brief Load a dataframe from a CSV file on several threads.
+     *
+     * The mapped file is split into byte ranges aligned on newlines; each range is
+     * parsed by its own worker into column fragments, which are then appended to the
+     * dataframe in file order, so the row order is the same as a sequential load.
+     *
+     * @param filename Path to the CSV file.
+     * @param types Column types in order.
+     * @param threads Number of worker threads (0 = the shared pool, see setThreadCount).
+     * @return Unique pointer owning the created dataframe.
+     */
+    static std::unique_ptr<CDataframe> loadFromCSVParallel(
+        const std::string& filename,
+        const std::vector<ColumnType>& types,
+        unsigned threads = 0
     );
 
     /**
      * @brief Load a dataframe from a CSV file by inferring column types automatically.
      *
      * @param filename Path to the CSV file.
+     * @param mode Reading strategy used once the types are inferred.
      * @return Unique pointer owning the created dataframe.
      */
-    static std::unique_ptr<CDataframe> loadFromCSVAuto(const std::string& filename);
+    static std::unique_ptr<CDataframe> loadFromCSVAuto(
+        const std::string& filename,
+        CSVReadMode mode = CSVReadMode::STREAM
+    );
 
     /**
      * @brief Save the dataframe to a CSV file.
@@ -290,6 +749,33 @@ public:
      */
     void saveToCSV(const std::string& filename) const;
 
+    // ===== BINARY METHODS =====
+
+    /**
+     * @brief Save the dataframe in the native binary columnar format.
+     *
+     * The file starts with a header (magic, version, row and column counts, then
+     * each column name and ColumnType), followed by one section per column holding
+     * its validity bitmap and its typed buffer, all aligned on 8 bytes.
+     * Numbers are written in native byte order. OBJECT values cannot be serialized
+     * and are saved as NULL.
+     *
+     * @param filename Output file path.
+     */
+    void saveToBinary(const std::string& filename) const;
+
+    /**
+     * @brief Load a dataframe saved with saveToBinary.
+     *
+     * The file is memory-mapped and each column buffer is filled with one bulk copy:
+     * no text parsing and no type inference.
+     *
+     * @param filename Path to the binary file.
+     * @return Unique pointer owning the created dataframe.
+     * @throws std::runtime_error if the file cannot be opened or is not a valid binary dataframe.
+     */
+    static std::unique_ptr<CDataframe> loadFromBinary(const std::string& filename);
+
     // ===== HELPERS =====
 
     /**
@@ -304,6 +790,9 @@ public:
     /**
      * @brief Retrieve a column by its name.
      *
+     * For a view (see filter), this is the column shared with the frame the
+     * view comes from, with all its rows.
+     *
      * @param name Column name.
      * @return Shared pointer to the column, or nullptr if not found.
      */
@@ -0,0 +1,108 @@
+// ========================= CSVBatchReader.cpp =========================
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+
+#include "CSVBatchReader.h"
+#include "CsvParsing.h"
+
+CSVBatchReader::CSVBatchReader(const std::string& filename,
+                               const std::vector<ColumnType>& types,
+                               size_t batchRows)
+    : file(filename, std::ios::binary)
+{
+    if (!this->file.is_open())
+        throw std::runtime_error("Cannot open file: " + filename);
+
+    this->types = types;
+    this->batchRows = std::max<size_t>(1, batchRows);
+    this->rows = 0;
+    this->buffer = std::vector<char>(CSV_READ_BLOCK);
+    this->begin = 0;
+    this->end = 0;
+    this->eof = false;
+
+    std::string_view header;
+    if (this->readLine(header))
+        this->names = splitCsvLine(header);
+}
+
+void CSVBatchReader::fill()
+{
+    // on garde la ligne incomplète en tête du buffer
+    const size_t pending = this->end - this->begin;
+    if (this->begin > 0 && pending > 0)
+        std::memmove(this->buffer.data(), this->buffer.data() + this->begin, pending);
+    this->begin = 0;
+    this->end = pending;
+
+    // une ligne plus longue que le buffer : on l'agrandit
+    if (this->end == this->buffer.size())
+        this->buffer.resize(this->buffer.size() * 2);
+
+    const size_t wanted = this->buffer.size() - this->end;
+    this->file.read(this->buffer.data() + this->end, static_cast<std::streamsize>(wanted));
+    const size_t got = static_cast<size_t>(this->file.gcount());
+
+    this->end += got;
+    if (got < wanted) this->eof = true;
+}
+
+bool CSVBatchReader::readLine(std::string_view& line)
+{
+    while (true) {
+        const char* p = this->buffer.data() + this->begin;
+        const char* stop = this->buffer.data() + this->end;
+
+        if (p < stop) {
+            const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(stop - p)));
+            if (nl || this->eof) {
+                line = nextCsvLine(p, stop);
+                this->begin = static_cast<size_t>(p - this->buffer.data());
+                return true;
+            }
+        } else if (this->eof) {
+            return false;
+        }
+
+        this->fill();
+    }
+}
+
+std::unique_ptr<CDataframe> CSVBatchReader::next()
+{
+    std::string_view line;
+    if (!this->readLine(line))
+        return nullptr;
+
+    auto df = std::make_unique<CDataframe>(this->types);
+    df->setColumnNames(this->names);
+
+    std::vector<Column*> cols;
+    cols.reserve(this->types.size());
+    for (size_t i = 0; i < this->types.size(); ++i) {
+        cols.push_back(df->getColumnByIndex(i).get());
+        cols.back()->reserve(this->batchRows);
+    }
+    beginCsvStringColumns(cols);
+
+    size_t n = 0;
+    do {
+        appendCsvLine(line, this->types, cols);
+        if (++n == DICTIONARY_SAMPLE_ROWS) settleCsvStringColumns(cols);
+    } while (n < this->batchRows && this->readLine(line));
+    settleCsvStringColumns(cols);
+
+    this->rows += n;
+    return df;
+}
+
+const std::vector<std::string>& CSVBatchReader::getColumnNames() const
+{
+    return this->names;
+}
+
+size_t CSVBatchReader::getRowsRead() const
+{
+    return this->rows;
+}
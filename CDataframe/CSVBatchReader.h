@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <fstream>
+
+#include "CDataframe.h"
+
+const size_t DEFAULT_BATCH_ROWS = 65536;
+const size_t CSV_READ_BLOCK = 1 << 20;
+
+/**
+ * @class CSVBatchReader
+ * @brief Streaming CSV cursor yielding the file as fixed-size CDataframe batches.
+ *
+ * The file is read by blocks of CSV_READ_BLOCK bytes and tokenized in place,
+ * so memory use is bounded by one block plus one batch, whatever the file size.
+ * Every batch has the same column types and names (taken from the header line).
+ *
+ * Typical use:
+ * @code
+ * CSVBatchReader reader("huge.csv", types);
+ * int count = 0;
+ * while (auto batch = reader.next())
+ *     count += batch->numberOfCellsGreaterThan(100);
+ * @endcode
+ */
+class CSVBatchReader
+{
+private:
+    std::ifstream file;
+    std::vector<ColumnType> types;
+    std::vector<std::string> names;
+    size_t batchRows;
+    size_t rows;
+
+    /**
+     * @brief Read buffer; bytes in [begin, end) are not consumed yet.
+     */
+    std::vector<char> buffer;
+    size_t begin;
+    size_t end;
+    bool eof;
+
+    /**
+     * @brief Read the next line from the file.
+     *
+     * @param line Receives the line (without '\n' / '\r'); valid until the next call.
+     * @return false once the whole file has been consumed.
+     */
+    bool readLine(std::string_view& line);
+
+    /**
+     * @brief Move unread bytes to the front of the buffer and read the next block.
+     */
+    void fill();
+
+public:
+    /**
+     * @brief Open a CSV file and read its header line.
+     *
+     * @param filename Path to the CSV file.
+     * @param types Column types in order.
+     * @param batchRows Maximum number of rows per batch.
+     * @throws std::runtime_error if the file cannot be opened.
+     */
+    CSVBatchReader(const std::string& filename,
+                   const std::vector<ColumnType>& types,
+                   size_t batchRows = DEFAULT_BATCH_ROWS);
+
+    /**
+     * @brief Read the next batch.
+     *
+     * @return A dataframe of at most batchRows rows, or nullptr once the file is exhausted.
+     */
+    std::unique_ptr<CDataframe> next();
+
+    /**
+     * @brief Column names read from the header line.
+     */
+    const std::vector<std::string>& getColumnNames() const;
+
+    /**
+     * @brief Number of data rows returned so far.
+     */
+    size_t getRowsRead() const;
+};
@@ -0,0 +1,218 @@
+// ========================= CsvParsing.cpp =========================
+#include <charconv>
+#include <cstring>
+#include <cctype>
+#include <system_error>
+
+#include "CsvParsing.h"
+
+// ----------------- Tokenizing -----------------
+
+std::vector<std::string> splitCsvLine(std::string_view line)
+{
+    std::vector<std::string> out;
+    size_t pos = 0;
+    while (pos < line.size()) {
+        size_t comma = line.find(',', pos);
+        if (comma == std::string_view::npos) {
+            out.emplace_back(line.substr(pos));
+            break;
+        }
+        out.emplace_back(line.substr(pos, comma - pos));
+        pos = comma + 1;
+    }
+    return out;
+}
+
+std::string_view trimView(std::string_view s)
+{
+    size_t a = 0, b = s.size();
+    while (a < b && std::isspace(static_cast<unsigned char>(s[a]))) ++a;
+    while (b > a && std::isspace(static_cast<unsigned char>(s[b-1]))) --b;
+    return s.substr(a, b - a);
+}
+
+bool isNullToken(std::string_view raw)
+{
+    const std::string_view s = trimView(raw);
+    return s.empty() || s == "NULL" || s == "null" || s == "NaN";
+}
+
+// ----------------- Numbers (std::from_chars) -----------------
+
+// from_chars n'accepte pas de '+' en tête : on le retire (mais pas "+-5")
+static bool stripPlus(std::string_view& s)
+{
+    if (!s.empty() && s.front() == '+') {
+        s.remove_prefix(1);
+        if (s.empty() || s.front() == '-') return false;
+    }
+    return !s.empty();
+}
+
+/**
+ * Parse an integer directly at the width of T.
+ * With `strict`, the whole view must be consumed; otherwise trailing
+ * characters are ignored like std::stol does.
+ */
+template <typename T>
+static bool parseInteger(std::string_view s, T& out, bool strict)
+{
+    if (!stripPlus(s)) return false;
+
+    const char* last = s.data() + s.size();
+    auto [ptr, ec] = std::from_chars(s.data(), last, out, 10);
+    if (ec != std::errc()) return false;
+    return !strict || ptr == last;
+}
+
+template <typename T>
+static bool parseFloating(std::string_view s, T& out, bool strict)
+{
+    if (!stripPlus(s)) return false;
+
+    const char* last = s.data() + s.size();
+    auto [ptr, ec] = std::from_chars(s.data(), last, out, std::chars_format::general);
+    if (ec != std::errc()) return false;
+    return !strict || ptr == last;
+}
+
+bool parseInt64(std::string_view raw, long long& out)
+{
+    return parseInteger(trimView(raw), out, true);
+}
+
+bool parseUInt64(std::string_view raw, unsigned long long& out)
+{
+    std::string_view s = trimView(raw);
+    // comme avant : pas de signe pour un non signé
+    if (!s.empty() && s.front() == '+') return false;
+    return parseInteger(s, out, true);
+}
+
+bool parseDouble(std::string_view raw, double& out)
+{
+    return parseFloating(trimView(raw), out, true);
+}
+
+template <typename T>
+static ColumnValue parseIntegerCell(std::string_view s)
+{
+    T v;
+    if (parseInteger(s, v, false)) return v;
+    return std::monostate{};
+}
+
+template <typename T>
+static ColumnValue parseFloatingCell(std::string_view s)
+{
+    T v;
+    if (parseFloating(s, v, false)) return v;
+    return std::monostate{};
+}
+
+// CHAR / UCHAR : un entier s'il en est un (hors bornes -> NULL), sinon le premier caractère
+template <typename T>
+static ColumnValue parseCharCell(std::string_view s)
+{
+    T v;
+    if (parseInteger(s, v, true)) return v;
+
+    long long wide;
+    if (parseInteger(s, wide, true)) return std::monostate{};
+
+    return static_cast<T>(s[0]);
+}
+
+ColumnValue parseByType(std::string_view raw, ColumnType t)
+{
+    const std::string_view s = trimView(raw);
+    if (isNullToken(s)) return std::monostate{};
+
+    switch (t) {
+        case ColumnType::NULLVAL:
+            return std::monostate{};
+
+        case ColumnType::STRING:
+            return std::string(s);
+
+        case ColumnType::DOUBLE: return parseFloatingCell<double>(s);
+        case ColumnType::FLOAT:  return parseFloatingCell<float>(s);
+
+        case ColumnType::INT:    return parseIntegerCell<int32_t>(s);
+        case ColumnType::UINT:   return parseIntegerCell<uint32_t>(s);
+        case ColumnType::SHORT:  return parseIntegerCell<int16_t>(s);
+        case ColumnType::USHORT: return parseIntegerCell<uint16_t>(s);
+        case ColumnType::LONG:   return parseIntegerCell<int64_t>(s);
+        case ColumnType::ULONG:  return parseIntegerCell<uint64_t>(s);
+
+        case ColumnType::CHAR:   return parseCharCell<int8_t>(s);
+        case ColumnType::UCHAR:  return parseCharCell<uint8_t>(s);
+
+        case ColumnType::OBJECT:
+            // CSV -> on stocke texte brut dans std::any
+            return std::any(std::string(s));
+
+        default:
+            return std::monostate{};
+    }
+}
+
+// ----------------- Lines -----------------
+
+std::string_view nextCsvLine(const char*& p, const char* end)
+{
+    const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+    const char* lineEnd = nl ? nl : end;
+
+    std::string_view line(p, static_cast<size_t>(lineEnd - p));
+    p = nl ? nl + 1 : end;
+
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    return line;
+}
+
+void appendCsvLine(std::string_view line,
+                   const std::vector<ColumnType>& types,
+                   const std::vector<Column*>& cols)
+{
+    size_t pos = 0;
+    for (size_t i = 0; i < types.size(); ++i) {
+        std::string_view field;
+        if (pos <= line.size()) {
+            size_t comma = line.find(',', pos);
+            if (comma == std::string_view::npos) {
+                field = line.substr(pos);
+                pos = line.size() + 1;
+            } else {
+                field = line.substr(pos, comma - pos);
+                pos = comma + 1;
+            }
+        }
+
+        // chaîne : copiée directement dans le stockage de la colonne
+        if (types[i] == ColumnType::STRING) {
+            const std::string_view s = trimView(field);
+            if (isNullToken(s)) cols[i]->insertValue(std::nullopt);
+            else cols[i]->insertString(s);
+            continue;
+        }
+
+        ColumnValue v = parseByType(field, types[i]);
+
+        if (std::holds_alternative<std::monostate>(v)) cols[i]->insertValue(std::nullopt);
+        else cols[i]->insertValue(std::move(v));
+    }
+}
+
+// ----------------- String encoding -----------------
+
+void beginCsvStringColumns(const std::vector<Column*>& cols)
+{
+    for (Column* c : cols) c->setDictionaryEncoding(true);
+}
+
+void settleCsvStringColumns(const std::vector<Column*>& cols)
+{
+    for (Column* c : cols) c->optimizeStringEncoding();
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+
+#include "../Column/Column.h"
+
+/**
+ * @file CsvParsing.h
+ * @brief Allocation-free, exception-free parsing helpers used by the CSV loaders.
+ *
+ * Every helper works on `std::string_view`s pointing into the input buffer.
+ * Numbers are parsed with `std::from_chars`: a bad cell is reported through
+ * the return value (or a NULL ColumnValue), never through an exception.
+ */
+
+/**
+ * @brief Split a line on ',' (legacy tokenizer, used for headers and the stream loader).
+ *
+ * @param line The line without its trailing newline.
+ * @return One string per field; a trailing empty field is dropped.
+ */
+std::vector<std::string> splitCsvLine(std::string_view line);
+
+/**
+ * @brief Remove leading and trailing whitespace.
+ */
+std::string_view trimView(std::string_view s);
+
+/**
+ * @brief Check whether a raw cell stands for a missing value.
+ *
+ * Empty cells and the tokens `NULL`, `null` and `NaN` are NULL.
+ */
+bool isNullToken(std::string_view raw);
+
+/**
+ * @brief Strictly parse a signed 64-bit integer (the whole trimmed cell must be consumed).
+ * @return true on success, false otherwise (out is then unspecified).
+ */
+bool parseInt64(std::string_view raw, long long& out);
+
+/**
+ * @brief Strictly parse an unsigned 64-bit integer (the whole trimmed cell must be consumed).
+ * @return true on success, false otherwise (out is then unspecified).
+ */
+bool parseUInt64(std::string_view raw, unsigned long long& out);
+
+/**
+ * @brief Strictly parse a double (the whole trimmed cell must be consumed).
+ * @return true on success, false otherwise (out is then unspecified).
+ */
+bool parseDouble(std::string_view raw, double& out);
+
+/**
+ * @brief Parse a raw cell into the ColumnValue alternative matching a column type.
+ *
+ * Integers are parsed directly at the width of the column, so that an out of
+ * range value is rejected instead of being truncated. As with `std::stol`,
+ * characters following a valid number are ignored (`"12.5"` in an INT column
+ * gives 12). A cell that cannot be parsed gives `std::monostate` (NULL).
+ *
+ * @param raw The raw cell (not trimmed).
+ * @param t The column type.
+ * @return The parsed value, or std::monostate for NULL / invalid cells.
+ */
+ColumnValue parseByType(std::string_view raw, ColumnType t);
+
+/**
+ * @brief Return the line starting at p and move p to the next one.
+ *
+ * The trailing '\n' (and '\r' for CRLF files) is not part of the result.
+ */
+std::string_view nextCsvLine(const char*& p, const char* end);
+
+/**
+ * @brief Tokenize one line and append its fields to the given columns.
+ *
+ * Missing fields are appended as NULL, extra fields are ignored.
+ *
+ * @param line The line without its trailing newline.
+ * @param types Column types, in order.
+ * @param cols Destination columns, one per type.
+ */
+void appendCsvLine(std::string_view line,
+                   const std::vector<ColumnType>& types,
+                   const std::vector<Column*>& cols);
+
+/**
+ * @brief Dictionary-encode the STRING columns about to be filled by a CSV loader.
+ *
+ * Loaders call it before the first row, then settleCsvStringColumns after
+ * DICTIONARY_SAMPLE_ROWS rows and once the load is complete, so that
+ * low-cardinality columns stay dictionary-encoded while high-cardinality
+ * ones go back to plain strings early. Other columns are left untouched.
+ */
+void beginCsvStringColumns(const std::vector<Column*>& cols);
+
+/**
+ * @brief Let every STRING column pick its encoding from its cardinality so far.
+ */
+void settleCsvStringColumns(const std::vector<Column*>& cols);
@@ -0,0 +1,477 @@
+// ========================= GroupBy.cpp =========================
+#include <algorithm>
+#include <type_traits>
+#include <string_view>
+#include <limits>
+
+#include "GroupBy.h"
+#include "CDataframe.h"
+#include "KeyTable.h"
+#include "ThreadPool.h"
+
+/**
+ * @brief Rows encoded and looked up together before the accumulators run on them
+ */
+static const size_t GROUP_BATCH_ROWS = 1024;
+
+/**
+ * @brief In PARALLEL mode, each partial table gets at least this many rows
+ */
+static const size_t GROUP_MIN_PARTITION_ROWS = 1 << 16;
+
+static const uint32_t NO_GROUP = std::numeric_limits<uint32_t>::max();
+
+/* -------------------- accumulators -------------------- */
+
+/**
+ * State of one aggregate for every group of a table. Each implementation is
+ * written for one column element type, so update() loops over a batch of
+ * rows with the type fixed.
+ */
+class Accumulator
+{
+public:
+    virtual ~Accumulator() {}
+
+    /**
+     * @brief Empty accumulator of the same aggregate, for another partial table
+     */
+    virtual std::unique_ptr<Accumulator> fresh() const = 0;
+
+    /**
+     * @brief Add the rows [begin, end); row i belongs to group groups[i - begin] (NO_GROUP: skipped)
+     * @param groupCount Number of groups of the table, some of them new
+     */
+    virtual void update(const uint32_t* groups, size_t begin, size_t end, size_t groupCount) = 0;
+
+    /**
+     * @brief Add the state of a partial accumulator, whose group g is group remap[g] here
+     */
+    virtual void merge(const Accumulator& other, const std::vector<uint32_t>& remap, size_t groupCount) = 0;
+
+    /**
+     * @brief Output column, one row per group
+     */
+    virtual Column result(const std::string& name) const = 0;
+};
+
+// Nombre de lignes par groupe (COUNT sans colonne)
+class RowCount : public Accumulator
+{
+private:
+    std::vector<uint64_t> counts;
+
+public:
+    std::unique_ptr<Accumulator> fresh() const override { return std::make_unique<RowCount>(); }
+
+    void update(const uint32_t* groups, size_t begin, size_t end, size_t groupCount) override
+    {
+        this->counts.resize(groupCount, 0);
+        for (size_t i = begin; i < end; ++i)
+            if (groups[i - begin] != NO_GROUP) this->counts[groups[i - begin]]++;
+    }
+
+    void merge(const Accumulator& other, const std::vector<uint32_t>& remap, size_t groupCount) override
+    {
+        const auto& o = static_cast<const RowCount&>(other);
+        this->counts.resize(groupCount, 0);
+        for (size_t g = 0; g < o.counts.size(); ++g) this->counts[remap[g]] += o.counts[g];
+    }
+
+    Column result(const std::string& name) const override
+    {
+        Column out(name, ColumnType::ULONG);
+        out.reserve(this->counts.size());
+        for (uint64_t c : this->counts) out.insertValue(c);
+        return out;
+    }
+};
+
+// Nombre de valeurs non NULL par groupe
+class ValueCount : public Accumulator
+{
+private:
+    const ValidityBitmap& validity;
+    std::vector<uint64_t> counts;
+
+public:
+    explicit ValueCount(const ValidityBitmap& validity) : validity(validity) {}
+
+    std::unique_ptr<Accumulator> fresh() const override { return std::make_unique<ValueCount>(this->validity); }
+
+    void update(const uint32_t* groups, size_t begin, size_t end, size_t groupCount) override
+    {
+        this->counts.resize(groupCount, 0);
+        end = std::min(end, this->validity.size());
+        for (size_t i = begin; i < end; ++i)
+            if (groups[i - begin] != NO_GROUP && this->validity.test(i)) this->counts[groups[i - begin]]++;
+    }
+
+    void merge(const Accumulator& other, const std::vector<uint32_t>& remap, size_t groupCount) override
+    {
+        const auto& o = static_cast<const ValueCount&>(other);
+        this->counts.resize(groupCount, 0);
+        for (size_t g = 0; g < o.counts.size(); ++g) this->counts[remap[g]] += o.counts[g];
+    }
+
+    Column result(const std::string& name) const override
+    {
+        Column out(name, ColumnType::ULONG);
+        out.reserve(this->counts.size());
+        for (uint64_t c : this->counts) out.insertValue(c);
+        return out;
+    }
+};
+
+// SUM et MEAN d'une colonne numérique de type T
+template <typename T>
+class SumAccumulator : public Accumulator
+{
+private:
+    // somme entière sur 64 bits (modulo 2^64 en cas de dépassement), double pour les flottants
+    using Sum = std::conditional_t<std::is_floating_point_v<T>, double,
+                std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+
+    TypedColumn<const T> column;
+    bool mean;
+    std::vector<Sum> sums;
+    std::vector<uint64_t> counts;
+
+public:
+    SumAccumulator(TypedColumn<const T> column, bool mean) : column(column), mean(mean) {}
+
+    std::unique_ptr<Accumulator> fresh() const override { return std::make_unique<SumAccumulator<T>>(this->column, this->mean); }
+
+    void update(const uint32_t* groups, size_t begin, size_t end, size_t groupCount) override
+    {
+        this->sums.resize(groupCount, Sum());
+        this->counts.resize(groupCount, 0);
+        const T* values = this->column.buffer().data();
+        end = std::min(end, this->column.size());
+        for (size_t i = begin; i < end; ++i) {
+            const uint32_t g = groups[i - begin];
+            if (g == NO_GROUP || !this->column.isValid(i)) continue;
+            this->sums[g] += static_cast<Sum>(values[i]);
+            this->counts[g]++;
+        }
+    }
+
+    void merge(const Accumulator& other, const std::vector<uint32_t>& remap, size_t groupCount) override
+    {
+        const auto& o = static_cast<const SumAccumulator<T>&>(other);
+        this->sums.resize(groupCount, Sum());
+        this->counts.resize(groupCount, 0);
+        for (size_t g = 0; g < o.sums.size(); ++g) {
+            this->sums[remap[g]] += o.sums[g];
+            this->counts[remap[g]] += o.counts[g];
+        }
+    }
+
+    Column result(const std::string& name) const override
+    {
+        const ColumnType type = this->mean ? ColumnType::DOUBLE
+                              : std::is_floating_point_v<Sum> ? ColumnType::DOUBLE
+                              : std::is_signed_v<Sum> ? ColumnType::LONG : ColumnType::ULONG;
+        Column out(name, type);
+        out.reserve(this->sums.size());
+        for (size_t g = 0; g < this->sums.size(); ++g) {
+            if (this->counts[g] == 0) out.insertValue(std::nullopt);
+            else if (this->mean) out.insertValue(static_cast<double>(this->sums[g]) / static_cast<double>(this->counts[g]));
+            else out.insertValue(this->sums[g]);
+        }
+        return out;
+    }
+};
+
+// MIN (MAX = false) ou MAX d'une colonne de type T : nombres, chaînes ou NULLVAL
+template <typename T, bool MAX>
+class ExtremumAccumulator : public Accumulator
+{
+private:
+    // les chaînes sont gardées en vues sur la colonne, copiées seulement dans le résultat
+    using Value = std::conditional_t<std::is_same_v<T, std::string>, std::string_view, T>;
+
+    TypedColumn<const T> column;
+    ColumnType type;
+    std::vector<Value> values;
+    std::vector<uint8_t> found;
+
+    // une valeur remplace la valeur retenue si elle est plus petite (plus grande), ou si celle-ci est NaN
+    static bool better(const Value& x, const Value& current)
+    {
+        if constexpr (std::is_floating_point_v<Value>) {
+            if (current != current) return x == x;
+        }
+        return MAX ? current < x : x < current;
+    }
+
+    void offer(uint32_t g, const Value& x)
+    {
+        if (!this->found[g]) {
+            this->values[g] = x;
+            this->found[g] = 1;
+        } else if (better(x, this->values[g])) {
+            this->values[g] = x;
+        }
+    }
+
+public:
+    ExtremumAccumulator(TypedColumn<const T> column, ColumnType type) : column(column), type(type) {}
+
+    std::unique_ptr<Accumulator> fresh() const override { return std::make_unique<ExtremumAccumulator<T, MAX>>(this->column, this->type); }
+
+    void update(const uint32_t* groups, size_t begin, size_t end, size_t groupCount) override
+    {
+        this->values.resize(groupCount, Value());
+        this->found.resize(groupCount, 0);
+        if constexpr (!std::is_same_v<T, std::monostate>) {
+            const auto& buffer = this->column.buffer();
+            end = std::min(end, this->column.size());
+            for (size_t i = begin; i < end; ++i) {
+                const uint32_t g = groups[i - begin];
+                if (g != NO_GROUP && this->column.isValid(i)) this->offer(g, buffer[i]);
+            }
+        }
+    }
+
+    void merge(const Accumulator& other, const std::vector<uint32_t>& remap, size_t groupCount) override
+    {
+        const auto& o = static_cast<const ExtremumAccumulator<T, MAX>&>(other);
+        this->values.resize(groupCount, Value());
+        this->found.resize(groupCount, 0);
+        for (size_t g = 0; g < o.values.size(); ++g)
+            if (o.found[g]) this->offer(remap[g], o.values[g]);
+    }
+
+    Column result(const std::string& name) const override
+    {
+        Column out(name, this->type);
+        out.reserve(this->values.size());
+        for (size_t g = 0; g < this->values.size(); ++g) {
+            if constexpr (std::is_same_v<T, std::monostate>) {
+                out.insertValue(std::nullopt);
+            } else {
+                if (!this->found[g]) out.insertValue(std::nullopt);
+                else if constexpr (std::is_same_v<T, std::string>) out.insertString(this->values[g]);
+                else out.insertValue(this->values[g]);
+            }
+        }
+        return out;
+    }
+};
+
+// Nombre de valeurs distinctes : une table des couples (groupe, valeur) déjà vus
+class DistinctCount : public Accumulator
+{
+private:
+    std::shared_ptr<const KeyEncoder> encoder;
+    KeyTable seen;
+    std::vector<uint64_t> counts;
+    std::vector<uint64_t> words;
+
+    void see(uint32_t g, uint64_t value)
+    {
+        const uint64_t pair[2] = {g, value};
+        bool inserted;
+        this->seen.insert(pair, KeyTable::hash(pair, 2), inserted);
+        if (inserted) this->counts[g]++;
+    }
+
+public:
+    explicit DistinctCount(std::shared_ptr<const KeyEncoder> encoder) : encoder(encoder), seen(2) {}
+
+    std::unique_ptr<Accumulator> fresh() const override { return std::make_unique<DistinctCount>(this->encoder); }
+
+    void update(const uint32_t* groups, size_t begin, size_t end, size_t groupCount) override
+    {
+        this->counts.resize(groupCount, 0);
+        this->words.resize((end - begin) * 2);
+        this->encoder->encode(begin, end, this->words.data());
+
+        // mot 0 : la valeur, mot 1 : non nul si elle est NULL
+        for (size_t i = begin; i < end; ++i) {
+            const uint64_t* key = this->words.data() + (i - begin) * 2;
+            if (groups[i - begin] != NO_GROUP && key[1] == 0) this->see(groups[i - begin], key[0]);
+        }
+    }
+
+    void merge(const Accumulator& other, const std::vector<uint32_t>& remap, size_t groupCount) override
+    {
+        const auto& o = static_cast<const DistinctCount&>(other);
+        this->counts.resize(groupCount, 0);
+        for (uint32_t id = 0; id < o.seen.size(); ++id) {
+            const uint64_t* pair = o.seen.key(id);
+            this->see(remap[pair[0]], pair[1]);
+        }
+    }
+
+    Column result(const std::string& name) const override
+    {
+        Column out(name, ColumnType::ULONG);
+        out.reserve(this->counts.size());
+        for (uint64_t c : this->counts) out.insertValue(c);
+        return out;
+    }
+};
+
+/**
+ * Accumulator of an aggregate on a column (nullptr = no column, COUNT only),
+ * resolved once on the column element type; nullptr if the aggregate does not
+ * apply to that type.
+ */
+static std::unique_ptr<Accumulator> makeAccumulator(const Column* col, AggregateOp op)
+{
+    if (!col) return op == AggregateOp::COUNT ? std::make_unique<RowCount>() : nullptr;
+
+    const ColumnStorage& storage = col->getStorage();
+    if (op == AggregateOp::COUNT) return std::make_unique<ValueCount>(storage.getValidity());
+    if (op == AggregateOp::COUNT_DISTINCT) {
+        auto encoder = std::make_shared<const KeyEncoder>(std::vector<const Column*>{col});
+        if (!encoder->isSupported()) return nullptr;
+        return std::make_unique<DistinctCount>(encoder);
+    }
+
+    const ColumnType type = col->getType();
+    return storage.typed([op, type](auto column) -> std::unique_ptr<Accumulator> {
+        using T = typename decltype(column)::element_type;
+
+        if constexpr (std::is_arithmetic_v<T>) {
+            if (op == AggregateOp::SUM || op == AggregateOp::MEAN)
+                return std::make_unique<SumAccumulator<T>>(column, op == AggregateOp::MEAN);
+        }
+        if constexpr (!std::is_same_v<T, std::any>) {
+            if (op == AggregateOp::MIN) return std::make_unique<ExtremumAccumulator<T, false>>(column, type);
+            if (op == AggregateOp::MAX) return std::make_unique<ExtremumAccumulator<T, true>>(column, type);
+        }
+        return nullptr;
+    });
+}
+
+static std::string aggregateName(const Aggregation& a)
+{
+    if (!a.name.empty()) return a.name;
+
+    std::string op;
+    switch (a.op) {
+        case AggregateOp::SUM:            op = "sum"; break;
+        case AggregateOp::MEAN:           op = "mean"; break;
+        case AggregateOp::MIN:            op = "min"; break;
+        case AggregateOp::MAX:            op = "max"; break;
+        case AggregateOp::COUNT:          op = "count"; break;
+        case AggregateOp::COUNT_DISTINCT: op = "count_distinct"; break;
+    }
+    return a.column.empty() ? op : op + "_" + a.column;
+}
+
+/* -------------------- GroupBy -------------------- */
+
+/**
+ * Groups and accumulators of one range of rows. Group ids follow the order
+ * of the first row of each group.
+ */
+struct PartialGroups {
+    KeyTable table;
+    std::vector<size_t> firstRow;
+    std::vector<std::unique_ptr<Accumulator>> accumulators;
+
+    explicit PartialGroups(size_t width) : table(width) {}
+};
+
+GroupBy::GroupBy(const CDataframe& frame, const std::vector<std::string>& keys)
+    : frame(frame), keys(keys), selection(nullptr)
+{
+}
+
+std::unique_ptr<CDataframe> GroupBy::agg(const std::vector<Aggregation>& aggregations, GroupByMode mode) const
+{
+    auto find = [this](const std::string& name) -> const Column* {
+        for (const auto& col : this->frame.columns)
+            if (col->getName() == name) return col.get();
+        return nullptr;
+    };
+
+    std::vector<const Column*> keyColumns;
+    for (const auto& name : this->keys) {
+        keyColumns.push_back(find(name));
+        if (!keyColumns.back()) return nullptr;
+    }
+    const KeyEncoder encoder(keyColumns);
+    if (!encoder.isSupported()) return nullptr;
+
+    std::vector<std::unique_ptr<Accumulator>> prototypes;
+    for (const auto& a : aggregations) {
+        const Column* col = a.column.empty() ? nullptr : find(a.column);
+        if (!a.column.empty() && !col) return nullptr;
+        prototypes.push_back(makeAccumulator(col, a.op));
+        if (!prototypes.back()) return nullptr;
+    }
+
+    // une table partielle par plage de lignes contiguës, au plus une par thread
+    const size_t rows = this->frame.storedRowsCount();
+    size_t parts = 1;
+    if (mode == GroupByMode::PARALLEL)
+        parts = std::max<size_t>(1, std::min<size_t>(ThreadPool::shared().size(), rows / GROUP_MIN_PARTITION_ROWS));
+
+    const size_t width = encoder.width();
+    std::vector<PartialGroups> partials;
+    partials.reserve(parts);
+    for (size_t p = 0; p < parts; ++p) {
+        partials.emplace_back(width);
+        for (const auto& proto : prototypes) partials.back().accumulators.push_back(proto->fresh());
+    }
+
+    ThreadPool::shared().parallelFor(parts, [&](size_t p) {
+        PartialGroups& part = partials[p];
+        const size_t begin = rows * p / parts;
+        const size_t end = rows * (p + 1) / parts;
+
+        std::vector<uint64_t> keys(GROUP_BATCH_ROWS * width);
+        std::vector<uint32_t> groups(GROUP_BATCH_ROWS);
+        for (size_t b = begin; b < end; b += GROUP_BATCH_ROWS) {
+            const size_t e = std::min(end, b + GROUP_BATCH_ROWS);
+            // lot sans aucune ligne sélectionnée : rien à encoder
+            if (this->selection && this->selection->countValid(b, e) == 0) continue;
+            encoder.encode(b, e, keys.data());
+
+            for (size_t i = b; i < e; ++i) {
+                if (this->selection ? !this->selection->test(i) : this->frame.isDeleted(i)) {
+                    groups[i - b] = NO_GROUP;
+                    continue;
+                }
+                const uint64_t* key = keys.data() + (i - b) * width;
+                bool inserted;
+                groups[i - b] = part.table.insert(key, KeyTable::hash(key, width), inserted);
+                if (inserted) part.firstRow.push_back(i);
+            }
+
+            for (auto& acc : part.accumulators) acc->update(groups.data(), b, e, part.table.size());
+        }
+    });
+
+    // fusion dans l'ordre des plages : les nouveaux groupes gardent l'ordre de leur première ligne
+    PartialGroups& total = partials.front();
+    for (size_t p = 1; p < parts; ++p) {
+        const PartialGroups& part = partials[p];
+        std::vector<uint32_t> remap(part.table.size());
+        for (uint32_t g = 0; g < part.table.size(); ++g) {
+            bool inserted;
+            remap[g] = total.table.insert(part.table.key(g), part.table.keyHash(g), inserted);
+            if (inserted) total.firstRow.push_back(part.firstRow[g]);
+        }
+        for (size_t a = 0; a < total.accumulators.size(); ++a)
+            total.accumulators[a]->merge(*part.accumulators[a], remap, total.table.size());
+    }
+
+    // les clés sont recopiées depuis la première ligne de chaque groupe, dans l'ordre des groupes
+    ValidityBitmap firstRows;
+    firstRows.resize(rows);
+    for (size_t row : total.firstRow) firstRows.set(row, true);
+
+    auto df = std::make_unique<CDataframe>();
+    for (const Column* col : keyColumns)
+        df->columns.push_back(std::make_shared<Column>(col->gather(firstRows)));
+
+    for (size_t a = 0; a < aggregations.size(); ++a)
+        df->columns.push_back(std::make_shared<Column>(total.accumulators[a]->result(aggregateName(aggregations[a]))));
+    return df;
+}
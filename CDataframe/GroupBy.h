@@ -0,0 +1,107 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <string>
+
+#include "../Column/Column.h"
+
+class CDataframe;
+
+/**
+ * @enum AggregateOp
+ * @brief Aggregate computed by GroupBy::agg on each group.
+ *
+ * NULL values are ignored by every aggregate; NaN is a value like any other
+ * (it propagates through SUM and MEAN, MIN and MAX only return it when the
+ * group holds nothing else, and COUNT_DISTINCT counts all NaNs as one value).
+ */
+enum class AggregateOp {
+    SUM,           /**< Sum, as LONG (signed integers), ULONG (unsigned integers) or DOUBLE; NULL if the group has no value */
+    MEAN,          /**< Mean as DOUBLE; NULL if the group has no value */
+    MIN,           /**< Smallest value, same type as the column (strings in lexicographic order) */
+    MAX,           /**< Largest value, same type as the column */
+    COUNT,         /**< Number of non-NULL values (number of rows without a column), as ULONG */
+    COUNT_DISTINCT /**< Number of distinct non-NULL values, as ULONG */
+};
+
+/**
+ * @struct Aggregation
+ * @brief One output column of GroupBy::agg: an aggregate of one column.
+ */
+struct Aggregation {
+    std::string column; /**< Aggregated column (empty for COUNT = number of rows) */
+    AggregateOp op;
+    std::string name;   /**< Output column name (empty = "<op>_<column>", e.g. "sum_price") */
+
+    static Aggregation sum(const std::string& column, const std::string& name = "") { return {column, AggregateOp::SUM, name}; }
+    static Aggregation mean(const std::string& column, const std::string& name = "") { return {column, AggregateOp::MEAN, name}; }
+    static Aggregation min(const std::string& column, const std::string& name = "") { return {column, AggregateOp::MIN, name}; }
+    static Aggregation max(const std::string& column, const std::string& name = "") { return {column, AggregateOp::MAX, name}; }
+    static Aggregation count(const std::string& column = "", const std::string& name = "") { return {column, AggregateOp::COUNT, name}; }
+    static Aggregation countDistinct(const std::string& column, const std::string& name = "") { return {column, AggregateOp::COUNT_DISTINCT, name}; }
+};
+
+/**
+ * @enum GroupByMode
+ * @brief How GroupBy::agg spreads the work.
+ */
+enum class GroupByMode {
+    SEQUENTIAL, /**< One hash table filled on the calling thread */
+    PARALLEL    /**< One partial table per worker on its own range of rows, merged at the end */
+};
+
+/**
+ * @class GroupBy
+ * @brief Rows of a CDataframe grouped by the values of one or more key columns.
+ *
+ * Obtained with CDataframe::groupBy; the frame must outlive it and must not
+ * be modified before agg is called.
+ *
+ * agg is a hash aggregation: every row is turned into a fixed-width key (see
+ * KeyEncoder), looked up in an open-addressing KeyTable that numbers the
+ * groups, and each aggregate updates a typed accumulator (one per column
+ * type and aggregate) indexed by group number. Rows are processed in batches
+ * so that each accumulator dispatches on its column type once per batch.
+ *
+ * Keys compare by value: NULL keys form a group of their own, NaN keys another.
+ * Groups come out in the order of their first row.
+ *
+ * @code
+ * auto totals = df.groupBy({"country", "year"}).agg({Aggregation::sum("amount"), Aggregation::count()});
+ * @endcode
+ */
+class GroupBy
+{
+private:
+    friend class LazyFrame;
+
+    const CDataframe& frame;
+    std::vector<std::string> keys;
+
+    /**
+     * @brief Stored rows to group (nullptr = every live row), set by LazyFrame to aggregate a filter without copying it.
+     */
+    const ValidityBitmap* selection;
+
+public:
+    /**
+     * @brief Group the rows of a frame by the given key columns.
+     */
+    GroupBy(const CDataframe& frame, const std::vector<std::string>& keys);
+
+    /**
+     * @brief Compute aggregates per group.
+     *
+     * @param aggregations Output columns to compute.
+     * @param mode Sequential or parallel (partial tables merged in row order,
+     *             with the same result as the sequential mode).
+     * @return A frame with the key columns (same names and types), then one
+     *         column per aggregation, one row per group; nullptr if a column
+     *         does not exist or an aggregate does not apply to its column type
+     *         (SUM / MEAN on a non-numeric column, MIN / MAX / COUNT_DISTINCT
+     *         on OBJECT, OBJECT keys).
+     */
+    std::unique_ptr<CDataframe> agg(const std::vector<Aggregation>& aggregations,
+                                    GroupByMode mode = GroupByMode::PARALLEL) const;
+};
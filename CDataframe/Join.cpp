@@ -0,0 +1,311 @@
+// ========================= Join.cpp =========================
+#include <algorithm>
+#include <functional>
+
+#include "CDataframe.h"
+#include "KeyTable.h"
+#include "ThreadPool.h"
+
+/**
+ * @brief Probe rows encoded and looked up together
+ */
+static const size_t JOIN_BATCH_ROWS = 1024;
+
+/**
+ * @brief In PARALLEL mode, the build side is partitioned and each probe range
+ *        gets at least this many rows
+ */
+static const size_t JOIN_MIN_PARTITION_ROWS = 1 << 16;
+
+/**
+ * One side of a join: its stored rows, their keys and the rows to skip.
+ */
+struct JoinSide {
+    const KeyEncoder& encoder;
+    size_t rows;
+    const ValidityBitmap& deleted;
+
+    bool isDeleted(size_t row) const { return row < this->deleted.size() && this->deleted.test(row); }
+};
+
+/**
+ * Part of the build table holding the keys whose hash falls in it. The build
+ * rows of a key are chained in increasing order: first[id], next[first[id]]...
+ * up to NO_ROW (`next` is shared by all the partitions, indexed by row).
+ */
+struct BuildPartition {
+    KeyTable table;
+    std::vector<uint32_t> first;
+    std::vector<uint32_t> last;
+
+    explicit BuildPartition(size_t width) : table(width) {}
+};
+
+struct BuildTable {
+    std::vector<BuildPartition> partitions;
+    std::vector<uint32_t> next;
+    unsigned bits; /**< 2^bits partitions, chosen by the high bits of the hash */
+
+    size_t partitionOf(uint64_t h) const { return this->bits ? static_cast<size_t>(h >> (64 - this->bits)) : 0; }
+};
+
+// task(0) ... task(count - 1), sur le pool partagé ou sur le thread appelant
+static void runTasks(size_t count, bool parallel, const std::function<void(size_t)>& task)
+{
+    if (parallel) {
+        ThreadPool::shared().parallelFor(count, task);
+        return;
+    }
+    for (size_t k = 0; k < count; ++k) task(k);
+}
+
+static BuildTable buildTable(const JoinSide& side, bool parallel)
+{
+    const size_t rows = side.rows;
+    const size_t w = side.encoder.width();
+
+    // clés et hachages de toutes les lignes, calculés par blocs en parallèle
+    std::vector<uint64_t> keys(rows * w);
+    std::vector<uint64_t> hashes(rows);
+    std::vector<uint8_t> usable(rows);
+    const size_t chunks = (rows + JOIN_MIN_PARTITION_ROWS - 1) / JOIN_MIN_PARTITION_ROWS;
+    runTasks(chunks, parallel, [&](size_t k) {
+        const size_t begin = k * JOIN_MIN_PARTITION_ROWS;
+        const size_t end = std::min(rows, begin + JOIN_MIN_PARTITION_ROWS);
+        side.encoder.encode(begin, end, keys.data() + begin * w);
+        for (size_t i = begin; i < end; ++i) {
+            const uint64_t* key = keys.data() + i * w;
+            usable[i] = !side.isDeleted(i) && !side.encoder.hasNull(key);
+            hashes[i] = KeyTable::hash(key, w);
+        }
+    });
+
+    BuildTable build;
+    build.bits = 0;
+    if (parallel && rows >= JOIN_MIN_PARTITION_ROWS)
+        while ((size_t{1} << build.bits) < ThreadPool::shared().size()) build.bits++;
+
+    const size_t partitions = size_t{1} << build.bits;
+    build.next.assign(rows, NO_ROW);
+    for (size_t p = 0; p < partitions; ++p) build.partitions.emplace_back(w);
+
+    // chaque partition lit toutes les lignes mais n'insère que les siennes : aucune écriture partagée
+    runTasks(partitions, parallel, [&](size_t p) {
+        BuildPartition& part = build.partitions[p];
+        for (size_t i = 0; i < rows; ++i) {
+            if (!usable[i] || build.partitionOf(hashes[i]) != p) continue;
+            bool inserted;
+            const uint32_t id = part.table.insert(keys.data() + i * w, hashes[i], inserted);
+            const uint32_t row = static_cast<uint32_t>(i);
+            if (inserted) {
+                part.first.push_back(row);
+                part.last.push_back(row);
+            } else {
+                build.next[part.last[id]] = row;
+                part.last[id] = row;
+            }
+        }
+    });
+    return build;
+}
+
+/**
+ * Look the live rows [begin, end) of the probe side up in the build table:
+ * visit(row, partition, id) for a match, visit(row, nullptr, 0) otherwise.
+ */
+template <typename F>
+static void probeRange(const JoinSide& side, const BuildTable& build, size_t begin, size_t end, F&& visit)
+{
+    const size_t w = side.encoder.width();
+    std::vector<uint64_t> keys(JOIN_BATCH_ROWS * w);
+
+    for (size_t b = begin; b < end; b += JOIN_BATCH_ROWS) {
+        const size_t e = std::min(end, b + JOIN_BATCH_ROWS);
+        side.encoder.encode(b, e, keys.data());
+
+        for (size_t i = b; i < e; ++i) {
+            if (side.isDeleted(i)) continue;
+            const uint64_t* key = keys.data() + (i - b) * w;
+            if (side.encoder.hasNull(key)) {
+                visit(i, nullptr, 0);
+                continue;
+            }
+            const uint64_t h = KeyTable::hash(key, w);
+            const BuildPartition& part = build.partitions[build.partitionOf(h)];
+            uint32_t id;
+            if (part.table.find(key, h, id)) visit(i, &part, id);
+            else visit(i, nullptr, 0);
+        }
+    }
+}
+
+std::unique_ptr<CDataframe> CDataframe::join(const CDataframe& other, const std::string& leftKey,
+                                             const std::string& rightKey, JoinKind kind, JoinMode mode) const
+{
+    auto find = [](const CDataframe& frame, const std::string& name) -> const Column* {
+        for (const auto& col : frame.columns)
+            if (col->getName() == name) return col.get();
+        return nullptr;
+    };
+    const Column* leftColumn = find(*this, leftKey);
+    const Column* rightColumn = find(other, rightKey);
+    if (!leftColumn || !rightColumn) return nullptr;
+
+    const size_t leftRows = this->storedRowsCount();
+    const size_t rightRows = other.storedRowsCount();
+    if (leftRows >= NO_ROW || rightRows >= NO_ROW) return nullptr;
+
+    // la table est construite sur le plus petit côté ; l'autre côté encode ses clés par rapport à elle
+    const bool buildLeft = this->getRowsCount() < other.getRowsCount();
+    const Column* buildColumn = buildLeft ? leftColumn : rightColumn;
+    const Column* probeColumn = buildLeft ? rightColumn : leftColumn;
+    const KeyEncoder buildEncoder({buildColumn}, true);
+    const KeyEncoder probeEncoder({probeColumn}, buildEncoder);
+    if (!buildEncoder.isSupported() || !probeEncoder.isSupported()) return nullptr;
+
+    const bool parallel = mode == JoinMode::PARALLEL;
+    const JoinSide left{buildLeft ? buildEncoder : probeEncoder, leftRows, this->deletedRows};
+    const JoinSide right{buildLeft ? probeEncoder : buildEncoder, rightRows, other.deletedRows};
+    const JoinSide& buildSide = buildLeft ? left : right;
+    const JoinSide& probeSide = buildLeft ? right : left;
+
+    const BuildTable build = buildTable(buildSide, parallel);
+
+    // plages de sonde alignées sur 64 lignes : chacune écrit ses propres mots de bitmap
+    const size_t probeRows = probeSide.rows;
+    size_t parts = 1;
+    if (parallel)
+        parts = std::max<size_t>(1, std::min<size_t>(ThreadPool::shared().size(), probeRows / JOIN_MIN_PARTITION_ROWS));
+    auto bound = [&](size_t p) { return p == parts ? probeRows : (probeRows * p / parts) & ~size_t{63}; };
+
+    // ----- SEMI : seulement les lignes de gauche qui ont une correspondance -----
+    if (kind == JoinKind::SEMI) {
+        std::vector<uint64_t> words((leftRows + 63) / 64, 0);
+
+        if (!buildLeft) {
+            runTasks(parts, parallel, [&](size_t p) {
+                probeRange(probeSide, build, bound(p), bound(p + 1),
+                    [&](size_t row, const BuildPartition* part, uint32_t) {
+                        if (part) words[row / 64] |= uint64_t{1} << (row % 64);
+                    });
+            });
+        } else {
+            // clés de gauche touchées, marquées par chaque plage de droite, puis leurs lignes
+            std::vector<std::vector<std::vector<uint8_t>>> hits(parts);
+            runTasks(parts, parallel, [&](size_t p) {
+                hits[p].resize(build.partitions.size());
+                for (size_t q = 0; q < build.partitions.size(); ++q)
+                    hits[p][q].assign(build.partitions[q].table.size(), 0);
+                probeRange(probeSide, build, bound(p), bound(p + 1),
+                    [&](size_t, const BuildPartition* part, uint32_t id) {
+                        if (part) hits[p][part - build.partitions.data()][id] = 1;
+                    });
+            });
+            for (size_t q = 0; q < build.partitions.size(); ++q) {
+                const BuildPartition& part = build.partitions[q];
+                for (uint32_t id = 0; id < part.table.size(); ++id) {
+                    const bool hit = std::any_of(hits.begin(), hits.end(),
+                        [&](const std::vector<std::vector<uint8_t>>& h) { return h[q][id] != 0; });
+                    if (!hit) continue;
+                    for (uint32_t row = part.first[id]; row != NO_ROW; row = build.next[row])
+                        words[row / 64] |= uint64_t{1} << (row % 64);
+                }
+            }
+        }
+
+        ValidityBitmap selection;
+        selection.assign(words.data(), leftRows);
+        return this->filterStored(selection, {}, FilterMode::COPY);
+    }
+
+    // ----- INNER / LEFT : couples (ligne de gauche, ligne de droite) -----
+    std::vector<std::vector<uint32_t>> partLeft(parts), partRight(parts);
+    runTasks(parts, parallel, [&](size_t p) {
+        std::vector<uint32_t>& probeOut = buildLeft ? partRight[p] : partLeft[p];
+        std::vector<uint32_t>& buildOut = buildLeft ? partLeft[p] : partRight[p];
+        const bool keepMisses = kind == JoinKind::LEFT && !buildLeft;
+
+        probeRange(probeSide, build, bound(p), bound(p + 1),
+            [&](size_t row, const BuildPartition* part, uint32_t id) {
+                if (!part) {
+                    if (keepMisses) {
+                        probeOut.push_back(static_cast<uint32_t>(row));
+                        buildOut.push_back(NO_ROW);
+                    }
+                    return;
+                }
+                for (uint32_t match = part->first[id]; match != NO_ROW; match = build.next[match]) {
+                    probeOut.push_back(static_cast<uint32_t>(row));
+                    buildOut.push_back(match);
+                }
+            });
+    });
+
+    std::vector<uint32_t> leftOut, rightOut;
+    if (!buildLeft) {
+        // plages sondées dans l'ordre des lignes de gauche : il suffit de les mettre bout à bout
+        size_t total = 0;
+        for (size_t p = 0; p < parts; ++p) total += partLeft[p].size();
+        leftOut.reserve(total);
+        rightOut.reserve(total);
+        for (size_t p = 0; p < parts; ++p) {
+            leftOut.insert(leftOut.end(), partLeft[p].begin(), partLeft[p].end());
+            rightOut.insert(rightOut.end(), partRight[p].begin(), partRight[p].end());
+        }
+    } else {
+        // tri par dénombrement sur la ligne de gauche ; stable, donc les lignes de droite restent croissantes
+        std::vector<size_t> offsets(leftRows + 1, 0);
+        for (size_t p = 0; p < parts; ++p)
+            for (uint32_t l : partLeft[p]) offsets[l + 1]++;
+
+        // LEFT : une case pour chaque ligne de gauche vivante sans correspondance
+        std::vector<uint8_t> alone(leftRows, 0);
+        if (kind == JoinKind::LEFT) {
+            for (size_t l = 0; l < leftRows; ++l) {
+                if (offsets[l + 1] != 0 || left.isDeleted(l)) continue;
+                alone[l] = 1;
+                offsets[l + 1] = 1;
+            }
+        }
+        for (size_t l = 0; l < leftRows; ++l) offsets[l + 1] += offsets[l];
+
+        leftOut.assign(offsets[leftRows], NO_ROW);
+        rightOut.assign(offsets[leftRows], NO_ROW);
+        for (size_t l = 0; l < leftRows; ++l)
+            if (alone[l]) leftOut[offsets[l]] = static_cast<uint32_t>(l);
+        for (size_t p = 0; p < parts; ++p) {
+            for (size_t k = 0; k < partLeft[p].size(); ++k) {
+                const size_t pos = offsets[partLeft[p][k]]++;
+                leftOut[pos] = partLeft[p][k];
+                rightOut[pos] = partRight[p][k];
+            }
+        }
+    }
+
+    // ----- colonnes du résultat, rassemblées à partir des couples -----
+    std::vector<const Column*> sources;
+    std::vector<const std::vector<uint32_t>*> picks;
+    std::vector<std::string> names;
+    for (const auto& col : this->columns) {
+        sources.push_back(col.get());
+        picks.push_back(&leftOut);
+        names.push_back(col->getName());
+    }
+    for (const auto& col : other.columns) {
+        if (col.get() == rightColumn) continue;
+        std::string name = col->getName();
+        while (std::find(names.begin(), names.end(), name) != names.end()) name += "_right";
+        sources.push_back(col.get());
+        picks.push_back(&rightOut);
+        names.push_back(name);
+    }
+
+    auto df = std::make_unique<CDataframe>();
+    df->columns.resize(sources.size());
+    runTasks(sources.size(), parallel, [&](size_t c) {
+        Column col = sources[c]->gather(*picks[c]);
+        col.setName(names[c]);
+        df->columns[c] = std::make_shared<Column>(std::move(col));
+    });
+    return df;
+}
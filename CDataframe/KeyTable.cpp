@@ -0,0 +1,307 @@
+// ========================= KeyTable.cpp =========================
+#include <cstring>
+#include <string_view>
+#include <functional>
+#include <type_traits>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "KeyTable.h"
+
+/* -------------------- KeyTable -------------------- */
+
+static const size_t KEY_TABLE_MIN_SLOTS = 16;
+
+// Finaliseur de splitmix64 : chaque bit d'entrée influence tous les bits de sortie
+static uint64_t mix(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+KeyTable::KeyTable(size_t width)
+{
+    this->width = width;
+    this->slots.assign(KEY_TABLE_MIN_SLOTS, 0);
+}
+
+uint64_t KeyTable::hash(const uint64_t* key, size_t width)
+{
+    uint64_t h = 0x9e3779b97f4a7c15ULL;
+    for (size_t k = 0; k < width; ++k) h = mix(h ^ key[k]);
+    return h;
+}
+
+void KeyTable::reserve(size_t n)
+{
+    this->keys.reserve(n * this->width);
+    this->hashes.reserve(n);
+
+    size_t wanted = this->slots.size();
+    while (wanted < 2 * n) wanted *= 2;
+    if (wanted > this->slots.size()) this->rehash(wanted);
+}
+
+void KeyTable::rehash(size_t slotCount)
+{
+    this->slots.assign(slotCount, 0);
+    const size_t mask = slotCount - 1;
+    for (uint32_t id = 0; id < this->hashes.size(); ++id) {
+        size_t i = this->hashes[id] & mask;
+        while (this->slots[i]) i = (i + 1) & mask;
+        this->slots[i] = id + 1;
+    }
+}
+
+uint32_t KeyTable::insert(const uint64_t* key, uint64_t h, bool& inserted)
+{
+    // au plus à moitié plein : les sondages restent courts
+    if (2 * (this->hashes.size() + 1) > this->slots.size()) this->rehash(2 * this->slots.size());
+
+    const size_t mask = this->slots.size() - 1;
+    const size_t bytes = this->width * sizeof(uint64_t);
+    for (size_t i = h & mask; ; i = (i + 1) & mask) {
+        const uint32_t slot = this->slots[i];
+        if (slot == 0) {
+            const uint32_t id = static_cast<uint32_t>(this->hashes.size());
+            this->slots[i] = id + 1;
+            this->hashes.push_back(h);
+            this->keys.insert(this->keys.end(), key, key + this->width);
+            inserted = true;
+            return id;
+        }
+        const uint32_t id = slot - 1;
+        if (this->hashes[id] == h && std::memcmp(this->key(id), key, bytes) == 0) {
+            inserted = false;
+            return id;
+        }
+    }
+}
+
+bool KeyTable::find(const uint64_t* key, uint64_t h, uint32_t& id) const
+{
+    const size_t mask = this->slots.size() - 1;
+    const size_t bytes = this->width * sizeof(uint64_t);
+    for (size_t i = h & mask; this->slots[i]; i = (i + 1) & mask) {
+        const uint32_t candidate = this->slots[i] - 1;
+        if (this->hashes[candidate] == h && std::memcmp(this->key(candidate), key, bytes) == 0) {
+            id = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* -------------------- StringNumbering -------------------- */
+
+StringNumbering::StringNumbering()
+{
+    this->slots.assign(KEY_TABLE_MIN_SLOTS, 0);
+}
+
+uint32_t StringNumbering::insert(std::string_view s)
+{
+    const std::hash<std::string_view> hasher;
+    if (2 * (this->strings.size() + 1) > this->slots.size()) {
+        this->slots.assign(this->slots.size() * 2, 0);
+        const size_t mask = this->slots.size() - 1;
+        for (uint32_t id = 0; id < this->strings.size(); ++id) {
+            size_t j = hasher(this->strings[id]) & mask;
+            while (this->slots[j]) j = (j + 1) & mask;
+            this->slots[j] = id + 1;
+        }
+    }
+
+    const size_t mask = this->slots.size() - 1;
+    size_t j = hasher(s) & mask;
+    while (this->slots[j] && this->strings[this->slots[j] - 1] != s) j = (j + 1) & mask;
+    if (!this->slots[j]) {
+        this->strings.push_back(s);
+        this->slots[j] = static_cast<uint32_t>(this->strings.size());
+    }
+    return this->slots[j] - 1;
+}
+
+bool StringNumbering::find(std::string_view s, uint32_t& id) const
+{
+    const size_t mask = this->slots.size() - 1;
+    for (size_t j = std::hash<std::string_view>()(s) & mask; this->slots[j]; j = (j + 1) & mask) {
+        if (this->strings[this->slots[j] - 1] == s) {
+            id = this->slots[j] - 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* -------------------- KeyEncoder -------------------- */
+
+// Drapeaux de colonne du dernier mot d'une clé (2 bits par colonne)
+static const uint64_t KEY_NULL = 1;
+static const uint64_t KEY_UNSIGNED = 2; // entier au-delà de INT64_MAX (encodage par valeur)
+static const uint64_t KEY_REAL = 3;     // flottant non entier, infini ou NaN (encodage par valeur)
+
+// Mot de clé d'une valeur non NULL
+template <typename T>
+static uint64_t keyWord(T x)
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        double d = static_cast<double>(x);
+        if (d != d) return 0x7ff8000000000000ULL; // un seul NaN
+        if (d == 0) d = 0.0;                      // -0.0 == 0.0
+        uint64_t bits;
+        std::memcpy(&bits, &d, sizeof(bits));
+        return bits;
+    } else if constexpr (std::is_signed_v<T>) {
+        return static_cast<uint64_t>(static_cast<int64_t>(x));
+    } else {
+        return static_cast<uint64_t>(x);
+    }
+}
+
+// Mot de clé par valeur : un nombre a le même mot quel que soit son type, le drapeau lève l'ambiguïté
+template <typename T>
+static uint64_t valueWord(T x, uint64_t& flag)
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        const double d = static_cast<double>(x);
+        if (d == std::trunc(d)) {
+            if (d >= -9223372036854775808.0 && d < 9223372036854775808.0)
+                return static_cast<uint64_t>(static_cast<int64_t>(d));
+            if (d > 0 && d < 18446744073709551616.0) {
+                flag = KEY_UNSIGNED;
+                return static_cast<uint64_t>(d);
+            }
+        }
+        flag = KEY_REAL;
+        return keyWord(x);
+    } else if constexpr (std::is_signed_v<T>) {
+        return static_cast<uint64_t>(static_cast<int64_t>(x));
+    } else {
+        if (static_cast<uint64_t>(x) > static_cast<uint64_t>(INT64_MAX)) flag = KEY_UNSIGNED;
+        return static_cast<uint64_t>(x);
+    }
+}
+
+static const StringColumn* stringsOf(const ColumnStorage& storage)
+{
+    const StringColumn* strings = nullptr;
+    storage.visit([&strings](const auto& vec) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(vec)>, StringColumn>) strings = &vec;
+    });
+    return strings;
+}
+
+KeyEncoder::KeyEncoder(const std::vector<const Column*>& columns, bool byValue)
+{
+    this->reference = nullptr;
+    this->byValue = byValue;
+    this->supported = columns.size() <= 32;
+    this->columns.resize(columns.size());
+
+    for (size_t c = 0; c < columns.size(); ++c) {
+        KeyColumn& key = this->columns[c];
+        key.storage = &columns[c]->getStorage();
+        key.strings = stringsOf(*key.storage);
+        if (columns[c]->getType() == ColumnType::OBJECT) this->supported = false;
+
+        // encodage par dictionnaire : les codes sont déjà des identifiants
+        if (!key.strings || key.strings->isDictionary()) continue;
+
+        const ValidityBitmap& validity = key.storage->getValidity();
+        key.rowIds.assign(key.strings->size(), 0);
+        for (size_t i = 0; i < key.strings->size(); ++i)
+            if (validity.test(i)) key.rowIds[i] = key.numbering.insert((*key.strings)[i]);
+    }
+}
+
+KeyEncoder::KeyEncoder(const std::vector<const Column*>& columns, const KeyEncoder& reference)
+{
+    this->reference = &reference;
+    this->byValue = true;
+    this->supported = reference.supported && reference.byValue && columns.size() == reference.columns.size();
+    this->columns.resize(columns.size());
+
+    for (size_t c = 0; c < columns.size(); ++c) {
+        KeyColumn& key = this->columns[c];
+        key.storage = &columns[c]->getStorage();
+        key.strings = stringsOf(*key.storage);
+
+        const ColumnType type = columns[c]->getType();
+        const ColumnType other = c < reference.columns.size() ? reference.columns[c].storage->type() : type;
+        const bool comparable = type == ColumnType::NULLVAL || other == ColumnType::NULLVAL
+                             || (type == ColumnType::STRING) == (other == ColumnType::STRING);
+        if (type == ColumnType::OBJECT || other == ColumnType::OBJECT || !comparable) this->supported = false;
+
+        // un dictionnaire se traduit une fois par code, les chaînes simples ligne à ligne dans encode
+        if (!this->supported || !key.strings || !key.strings->isDictionary()) continue;
+        const std::vector<std::string_view>& dictionary = key.strings->getDictionary();
+        key.codeIds.resize(dictionary.size());
+        for (size_t code = 0; code < dictionary.size(); ++code)
+            key.codeIds[code] = reference.stringId(c, dictionary[code]);
+    }
+}
+
+uint32_t KeyEncoder::stringId(size_t c, std::string_view s) const
+{
+    const KeyColumn& key = this->columns[c];
+    uint32_t id;
+    if (!key.strings) return NO_STRING_ID;
+    if (key.strings->isDictionary()) return key.strings->findCode(s, id) ? id : NO_STRING_ID;
+    return key.numbering.find(s, id) ? id : NO_STRING_ID;
+}
+
+void KeyEncoder::encode(size_t begin, size_t end, uint64_t* out) const
+{
+    const size_t w = this->width();
+    const size_t flagWord = this->columns.size();
+    for (size_t i = begin; i < end; ++i) out[(i - begin) * w + flagWord] = 0;
+
+    for (size_t c = 0; c < this->columns.size(); ++c) {
+        const KeyColumn& col = this->columns[c];
+        const ColumnStorage& storage = *col.storage;
+        const ValidityBitmap& validity = storage.getValidity();
+        const size_t stop = std::min(end, storage.size());
+        const unsigned shift = static_cast<unsigned>(2 * c);
+
+        // un seul choix de type par colonne, puis une boucle typée sur les lignes
+        storage.visit([&](const auto& vec) {
+            using V = std::decay_t<decltype(vec)>;
+            for (size_t i = begin; i < end; ++i) {
+                uint64_t* key = out + (i - begin) * w;
+                if (i >= stop || !validity.test(i)) {
+                    key[c] = 0;
+                    key[flagWord] |= KEY_NULL << shift;
+                    continue;
+                }
+                if constexpr (std::is_same_v<V, StringColumn>) {
+                    if (!this->reference) key[c] = vec.isDictionary() ? vec.getCodes()[i] : col.rowIds[i];
+                    else if (vec.isDictionary()) key[c] = col.codeIds[vec.getCodes()[i]];
+                    else key[c] = this->reference->stringId(c, vec[i]);
+                } else if constexpr (std::is_arithmetic_v<typename BufferElement<V>::type>) {
+                    if (this->byValue) {
+                        uint64_t flag = 0;
+                        key[c] = valueWord(vec[i], flag);
+                        key[flagWord] |= flag << shift;
+                    } else {
+                        key[c] = keyWord(vec[i]);
+                    }
+                } else {
+                    key[c] = 0;
+                }
+            }
+        });
+    }
+}
+
+bool KeyEncoder::hasNull(const uint64_t* key) const
+{
+    // couples de bits valant exactement 01
+    const uint64_t flags = key[this->columns.size()];
+    return (flags & ~(flags >> 1) & 0x5555555555555555ULL) != 0;
+}
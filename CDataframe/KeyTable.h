@@ -0,0 +1,238 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "../Column/Column.h"
+
+/**
+ * @class KeyTable
+ * @brief Open-addressing hash table of fixed-width keys, numbered in insertion order.
+ *
+ * Every key is `width` 64-bit words (see KeyEncoder). Keys are stored back to
+ * back and get the ids 0, 1, 2... in the order they are first inserted; the
+ * slots only hold ids, so growing the table moves 4 bytes per key. Slots are
+ * probed linearly and the table is kept at most half full.
+ */
+class KeyTable
+{
+private:
+    size_t width;
+    std::vector<uint64_t> keys;
+    std::vector<uint64_t> hashes;
+
+    /**
+     * @brief Id + 1 of the key stored in each slot, 0 for an empty slot.
+     */
+    std::vector<uint32_t> slots;
+
+    /**
+     * @brief Spread the ids over `slotCount` slots (a power of two).
+     */
+    void rehash(size_t slotCount);
+
+public:
+    /**
+     * @brief Empty table of keys of `width` words.
+     */
+    explicit KeyTable(size_t width);
+
+    /**
+     * @brief Hash of a key of `width` words.
+     */
+    static uint64_t hash(const uint64_t* key, size_t width);
+
+    /**
+     * @brief Number of distinct keys.
+     */
+    size_t size() const { return this->hashes.size(); }
+
+    /**
+     * @brief Number of words of a key.
+     */
+    size_t keyWidth() const { return this->width; }
+
+    /**
+     * @brief Words of the key of a given id.
+     */
+    const uint64_t* key(uint32_t id) const { return this->keys.data() + id * this->width; }
+
+    /**
+     * @brief Hash of the key of a given id.
+     */
+    uint64_t keyHash(uint32_t id) const { return this->hashes[id]; }
+
+    /**
+     * @brief Reserve room for n keys.
+     */
+    void reserve(size_t n);
+
+    /**
+     * @brief Id of a key, inserted first if it is not in the table yet.
+     *
+     * @param key Words of the key.
+     * @param h hash(key, keyWidth()).
+     * @param inserted Set to true if the key was added by this call.
+     */
+    uint32_t insert(const uint64_t* key, uint64_t h, bool& inserted);
+
+    /**
+     * @brief Look a key up without inserting it.
+     *
+     * @param id Receives the id of the key if it is found.
+     * @return false if the key is not in the table.
+     */
+    bool find(const uint64_t* key, uint64_t h, uint32_t& id) const;
+};
+
+/**
+ * @class StringNumbering
+ * @brief Ids 0, 1, 2... given to distinct strings in the order they are first seen.
+ *
+ * Strings are kept as views: the column they come from must outlive the numbering.
+ */
+class StringNumbering
+{
+private:
+    std::vector<std::string_view> strings;
+
+    /**
+     * @brief Id + 1 of the string stored in each slot, 0 for an empty slot.
+     */
+    std::vector<uint32_t> slots;
+
+public:
+    StringNumbering();
+
+    /**
+     * @brief Number of distinct strings.
+     */
+    size_t size() const { return this->strings.size(); }
+
+    /**
+     * @brief String of a given id.
+     */
+    std::string_view at(uint32_t id) const { return this->strings[id]; }
+
+    /**
+     * @brief Id of a string, numbered first if it was not seen yet.
+     */
+    uint32_t insert(std::string_view s);
+
+    /**
+     * @brief Id of a string already seen.
+     * @return false if the string was never inserted.
+     */
+    bool find(std::string_view s, uint32_t& id) const;
+};
+
+/**
+ * @brief Id of a string no reference row holds (see KeyEncoder)
+ */
+const uint32_t NO_STRING_ID = 0xffffffffu;
+
+/**
+ * @class KeyEncoder
+ * @brief Encode the values of one or more key columns as KeyTable keys.
+ *
+ * Row i becomes width() words: one word per column, then one flag word with
+ * two bits per column (bits 2k and 2k + 1 for the k-th column), 1 when the
+ * value is NULL (its value word is then 0) and 0 otherwise. Two rows get the
+ * same words exactly when their key values are equal, NaN being equal to NaN
+ * and -0.0 to 0.0:
+ * - integers: the value as a 64-bit integer,
+ * - floats: the bits of the value converted to double,
+ * - strings: the dictionary code, or an id given to each distinct string once,
+ *   when the encoder is built.
+ *
+ * Those words only compare within one column. To compare the keys of two
+ * frames (a join), the encoder of one side is built by value and the encoder
+ * of the other side against it: numbers are then encoded by value whatever
+ * their type (3, 3u and 3.0 get the same words; flags 2 and 3 mark unsigned
+ * values above INT64_MAX and non-integral floats), and strings get the ids of
+ * the reference encoder.
+ *
+ * OBJECT columns cannot be encoded, nor more than 32 columns. The encoder reads
+ * the columns it was built on, which must not be modified while it is in use.
+ */
+class KeyEncoder
+{
+private:
+    /**
+     * @brief One key column and, for strings, how its rows get their ids.
+     */
+    struct KeyColumn {
+        const ColumnStorage* storage;
+        const StringColumn* strings;    /**< nullptr for other types */
+        std::vector<uint32_t> rowIds;   /**< Plain strings: id of each row (without reference) */
+        std::vector<uint32_t> codeIds;  /**< Dictionary strings against a reference: id of each code */
+        StringNumbering numbering;      /**< Plain strings: the numbering behind rowIds */
+    };
+
+    std::vector<KeyColumn> columns;
+
+    /**
+     * @brief Encoder whose string ids this one uses (nullptr if it numbers its own strings)
+     */
+    const KeyEncoder* reference;
+
+    bool byValue;
+    bool supported;
+
+    /**
+     * @brief Id of a string of column c in this encoder's numbering, NO_STRING_ID if it has none
+     */
+    uint32_t stringId(size_t c, std::string_view s) const;
+
+public:
+    /**
+     * @brief Prepare the encoding of a set of columns (strings are numbered here, in one pass).
+     *
+     * @param byValue Encode numbers by value, so that another encoder can be
+     *                built against this one.
+     */
+    explicit KeyEncoder(const std::vector<const Column*>& columns, bool byValue = false);
+
+    /**
+     * @brief Prepare the encoding of columns compared with the columns of another encoder.
+     *
+     * Column k is compared with column k of `reference`, which must be built
+     * by value and outlive this encoder. Both must be numbers, or both strings
+     * (a NULLVAL column goes with anything); isSupported() is false otherwise.
+     * A string the reference never saw gets NO_STRING_ID.
+     */
+    KeyEncoder(const std::vector<const Column*>& columns, const KeyEncoder& reference);
+
+    /**
+     * @brief Not copyable: the string ids of a copy would still point into this encoder.
+     */
+    KeyEncoder(const KeyEncoder&) = delete;
+    KeyEncoder& operator=(const KeyEncoder&) = delete;
+
+    /**
+     * @brief false if a column cannot be encoded (the encoder must then not be used).
+     */
+    bool isSupported() const { return this->supported; }
+
+    /**
+     * @brief Number of words of a key.
+     */
+    size_t width() const { return this->columns.size() + 1; }
+
+    /**
+     * @brief Encode the rows [begin, end), width() words per row.
+     *
+     * Rows past the end of a column are encoded as NULL in that column.
+     *
+     * @param out Receives (end - begin) * width() words.
+     */
+    void encode(size_t begin, size_t end, uint64_t* out) const;
+
+    /**
+     * @brief true if a key (of width() words) has a NULL column.
+     */
+    bool hasNull(const uint64_t* key) const;
+};
@@ -0,0 +1,205 @@
+// ========================= LazyFrame.cpp =========================
+#include <algorithm>
+
+#include "LazyFrame.h"
+
+/**
+ * @brief true if a filter step can be merged with its neighbours into one AND
+ */
+static bool isConjunctive(const std::vector<ColumnPredicate>& predicates, PredicateCombine combine)
+{
+    return combine == PredicateCombine::AND || predicates.size() == 1;
+}
+
+LazyFrame CDataframe::lazy() const
+{
+    return LazyFrame(*this);
+}
+
+LazyFrame::LazyFrame(const CDataframe& frame)
+    : frame(&frame)
+{
+}
+
+LazyFrame LazyFrame::then(Step step) const
+{
+    LazyFrame next(*this);
+    next.steps.push_back(std::move(step));
+    return next;
+}
+
+LazyFrame LazyFrame::filter(const std::vector<ColumnPredicate>& predicates, PredicateCombine combine) const
+{
+    return this->then({Step::Kind::FILTER, predicates, combine, {}, {}, {}, GroupByMode::PARALLEL});
+}
+
+LazyFrame LazyFrame::select(const std::vector<std::string>& columns) const
+{
+    return this->then({Step::Kind::SELECT, {}, PredicateCombine::AND, columns, {}, {}, GroupByMode::PARALLEL});
+}
+
+LazyFrame LazyFrame::sortBy(const std::vector<SortKey>& keys) const
+{
+    return this->then({Step::Kind::SORT, {}, PredicateCombine::AND, {}, keys, {}, GroupByMode::PARALLEL});
+}
+
+LazyFrame LazyFrame::aggregate(const std::vector<std::string>& keys,
+                               const std::vector<Aggregation>& aggregations, GroupByMode mode) const
+{
+    return this->then({Step::Kind::AGGREGATE, {}, PredicateCombine::AND, keys, {}, aggregations, mode});
+}
+
+std::unique_ptr<CDataframe> LazyFrame::collect() const
+{
+    // état courant : des lignes stockées de `source` (sélection, puis ordre d'un tri) et ses colonnes visibles
+    const CDataframe* source = this->frame;
+    std::unique_ptr<CDataframe> owned;   // tableau intermédiaire : résultat d'un agrégat, ou avant un second tri
+    ValidityBitmap selection;
+    bool selected = false;
+    std::vector<uint32_t> order;
+    bool ordered = false;
+    std::vector<std::string> visible;    // colonnes gardées par un select (vide = toutes)
+
+    auto current = [&]() {
+        if (!visible.empty()) return visible;
+        std::vector<std::string> names;
+        for (const auto& col : source->columns) names.push_back(col->getName());
+        return names;
+    };
+    auto known = [&](const std::string& name) {
+        const std::vector<std::string> names = current();
+        return std::find(names.begin(), names.end(), name) != names.end();
+    };
+
+    // colonnes visibles que liront les étapes à partir de `from` (jusqu'au select ou à l'agrégat qui les remplace)
+    auto needed = [&](size_t from) {
+        std::vector<std::string> used;
+        bool all = true;
+        for (size_t i = from; i < this->steps.size() && all; ++i) {
+            const Step& step = this->steps[i];
+            switch (step.kind) {
+            case Step::Kind::FILTER:
+                for (const auto& p : step.predicates) used.push_back(p.column);
+                break;
+            case Step::Kind::SORT:
+                for (const auto& k : step.sortKeys) used.push_back(k.column);
+                break;
+            case Step::Kind::SELECT:
+                used.insert(used.end(), step.columns.begin(), step.columns.end());
+                all = step.columns.empty();
+                break;
+            case Step::Kind::AGGREGATE:
+                used.insert(used.end(), step.columns.begin(), step.columns.end());
+                for (const auto& a : step.aggregations) used.push_back(a.column);
+                all = false;
+                break;
+            }
+        }
+
+        std::vector<std::string> kept;
+        for (const auto& name : current())
+            if (all || std::find(used.begin(), used.end(), name) != used.end()) kept.push_back(name);
+        // rien à retirer : toutes les colonnes, même celles de noms répétés
+        if (visible.empty() && kept.size() == source->columns.size()) kept.clear();
+        return kept;
+    };
+
+    // l'état courant devient un tableau (seul moment où des colonnes sont rassemblées)
+    auto materialize = [&](const std::vector<std::string>& columns) {
+        std::unique_ptr<CDataframe> df;
+        if (ordered) {
+            if (selected)
+                order.erase(std::remove_if(order.begin(), order.end(),
+                                           [&selection](uint32_t row) { return !selection.test(row); }),
+                            order.end());
+            df = source->gatherStored(order, columns);
+        } else {
+            if (!selected) source->selectStored({}, PredicateCombine::AND, selection);
+            df = source->filterStored(selection, columns, FilterMode::COPY);
+        }
+        if (!df) return false;
+
+        owned = std::move(df);
+        source = owned.get();
+        selected = ordered = false;
+        order.clear();
+        visible.clear();
+        return true;
+    };
+
+    for (size_t i = 0; i < this->steps.size(); ++i) {
+        const Step& step = this->steps[i];
+        switch (step.kind) {
+        case Step::Kind::FILTER: {
+            // filtres en ET consécutifs : évalués ensemble, en un passage sur les blocs de lignes
+            std::vector<ColumnPredicate> predicates = step.predicates;
+            PredicateCombine combine = step.combine;
+            if (isConjunctive(predicates, combine)) {
+                combine = PredicateCombine::AND;
+                while (i + 1 < this->steps.size() && this->steps[i + 1].kind == Step::Kind::FILTER &&
+                       isConjunctive(this->steps[i + 1].predicates, this->steps[i + 1].combine)) {
+                    ++i;
+                    predicates.insert(predicates.end(), this->steps[i].predicates.begin(),
+                                      this->steps[i].predicates.end());
+                }
+            }
+            for (const auto& p : predicates)
+                if (!known(p.column)) return nullptr;
+
+            ValidityBitmap matched;
+            if (!source->selectStored(predicates, combine, matched)) return nullptr;
+            if (selected) {
+                std::vector<uint64_t> words = selection.raw();
+                const std::vector<uint64_t>& other = matched.raw();
+                for (size_t w = 0; w < words.size(); ++w) words[w] &= other[w];
+                selection.assign(words.data(), matched.size());
+            } else {
+                selection = std::move(matched);
+            }
+            selected = true;
+            break;
+        }
+
+        case Step::Kind::SELECT:
+            for (const auto& name : step.columns)
+                if (!known(name)) return nullptr;
+            if (!step.columns.empty()) visible = step.columns;
+            break;
+
+        case Step::Kind::SORT:
+            for (const auto& k : step.sortKeys)
+                if (!known(k.column)) return nullptr;
+            // un second tri doit rester stable par rapport au premier : il part du résultat de celui-ci
+            if (ordered && !materialize(needed(i))) return nullptr;
+            if (!source->sortStored(step.sortKeys, order, selected ? &selection : nullptr)) return nullptr;
+            ordered = true;
+            selected = false;
+            break;
+
+        case Step::Kind::AGGREGATE: {
+            for (const auto& name : step.columns)
+                if (!known(name)) return nullptr;
+            for (const auto& a : step.aggregations)
+                if (!a.column.empty() && !known(a.column)) return nullptr;
+            // les groupes sortent dans l'ordre de leur première ligne : après un tri, celui du tri
+            if (ordered && !materialize(needed(i))) return nullptr;
+
+            // filtre + agrégat : les lignes non sélectionnées sont sautées, sans tableau filtré
+            GroupBy grouping(*source, step.columns);
+            grouping.selection = selected ? &selection : nullptr;
+            std::unique_ptr<CDataframe> df = grouping.agg(step.aggregations, step.mode);
+            if (!df) return nullptr;
+
+            owned = std::move(df);
+            source = owned.get();
+            selected = false;
+            visible.clear();
+            break;
+        }
+        }
+    }
+
+    if (owned && !selected && !ordered && visible.empty()) return owned;
+    if (!materialize(visible)) return nullptr;
+    return owned;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <string>
+
+#include "CDataframe.h"
+
+/**
+ * @class LazyFrame
+ * @brief Query on a CDataframe recorded as a plan of steps and run by collect.
+ *
+ * Obtained with CDataframe::lazy. filter, select, sortBy and aggregate do
+ * no work: each returns a new LazyFrame with one more step. collect runs the
+ * whole plan at once and builds only the final frame:
+ * - filters only produce a selection bitmap, consecutive filters combined
+ *   with AND are evaluated as one (each chunk of rows runs all their predicates
+ *   while its words are in cache), and later filters intersect the bitmap;
+ * - an aggregate or a sort after filters runs on the selected rows directly,
+ *   no filtered frame is built in between;
+ * - columns are only gathered at the end, and only those that the plan
+ *   keeps (select) or still needs.
+ *
+ * Steps behave as the eager operations they stand for; a step naming a
+ * column that the previous steps removed makes collect fail. The frame must
+ * outlive the LazyFrame and must not be modified before collect.
+ *
+ * @code
+ * auto top = df.lazy()
+ *              .filter({ColumnPredicate::greater("amount", 100)})
+ *              .aggregate({"country"}, {Aggregation::sum("amount")})
+ *              .sortBy({SortKey::desc("sum_amount")})
+ *              .collect();
+ * @endcode
+ */
+class LazyFrame
+{
+private:
+    /**
+     * @brief One step of the plan, with the arguments of its eager operation.
+     */
+    struct Step {
+        enum class Kind { FILTER, SELECT, SORT, AGGREGATE };
+
+        Kind kind;
+        std::vector<ColumnPredicate> predicates;  /**< FILTER */
+        PredicateCombine combine;                 /**< FILTER */
+        std::vector<std::string> columns;         /**< SELECT columns, AGGREGATE keys */
+        std::vector<SortKey> sortKeys;            /**< SORT */
+        std::vector<Aggregation> aggregations;    /**< AGGREGATE */
+        GroupByMode mode;                         /**< AGGREGATE */
+    };
+
+    const CDataframe* frame;  /**< Pointer rather than reference: plans are built by reassignment (`q = q.filter(...)`) */
+    std::vector<Step> steps;
+
+    /**
+     * @brief Copy of this plan with one more step.
+     */
+    LazyFrame then(Step step) const;
+
+public:
+    /**
+     * @brief Empty plan on a frame (collect returns a copy of it).
+     */
+    explicit LazyFrame(const CDataframe& frame);
+
+    /**
+     * @brief Keep the rows satisfying a set of predicates (see CDataframe::filter).
+     */
+    LazyFrame filter(const std::vector<ColumnPredicate>& predicates,
+                     PredicateCombine combine = PredicateCombine::AND) const;
+
+    /**
+     * @brief Keep only the given columns, in that order (empty = all columns).
+     */
+    LazyFrame select(const std::vector<std::string>& columns) const;
+
+    /**
+     * @brief Sort the rows by one or more key columns (see CDataframe::sortBy).
+     */
+    LazyFrame sortBy(const std::vector<SortKey>& keys) const;
+
+    /**
+     * @brief Replace the rows by one row per group (see GroupBy::agg).
+     */
+    LazyFrame aggregate(const std::vector<std::string>& keys,
+                        const std::vector<Aggregation>& aggregations,
+                        GroupByMode mode = GroupByMode::PARALLEL) const;
+
+    /**
+     * @brief Run the plan.
+     *
+     * @return The resulting frame, or nullptr if a step names an unknown
+     *         column (or one removed by an earlier step), or fails as its
+     *         eager operation would.
+     */
+    std::unique_ptr<CDataframe> collect() const;
+};
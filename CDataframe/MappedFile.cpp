@@ -0,0 +1,69 @@
+// ========================= MappedFile.cpp =========================
+#include <stdexcept>
+#include <fstream>
+#include <iterator>
+
+#include "MappedFile.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MAPPEDFILE_HAS_MMAP 1
+#endif
+
+#ifdef MAPPEDFILE_HAS_MMAP
+
+MappedFile::MappedFile(const std::string& filename)
+{
+    this->begin = nullptr;
+    this->length = 0;
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("Cannot open file: " + filename);
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot stat file: " + filename);
+    }
+
+    this->length = static_cast<size_t>(st.st_size);
+    if (this->length > 0) {
+        void* p = ::mmap(nullptr, this->length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot map file: " + filename);
+        }
+        ::madvise(p, this->length, MADV_SEQUENTIAL);
+        this->begin = static_cast<const char*>(p);
+    }
+
+    // le mapping reste valide après fermeture du descripteur
+    ::close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (this->begin)
+        ::munmap(const_cast<char*>(this->begin), this->length);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("Cannot open file: " + filename);
+
+    this->fallback.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    this->begin = this->fallback.empty() ? nullptr : this->fallback.data();
+    this->length = this->fallback.size();
+}
+
+MappedFile::~MappedFile() {}
+
+#endif
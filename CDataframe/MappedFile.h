@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+/**
+ * @class MappedFile
+ * @brief Read-only memory mapping of a whole file (RAII).
+ *
+ * The file content is exposed as a contiguous byte range that stays valid for
+ * the lifetime of the object, so that parsers can hand out `std::string_view`s
+ * into it without copying. On platforms without `mmap` the file is read into
+ * an owned buffer instead.
+ */
+class MappedFile
+{
+private:
+    const char* begin;
+    size_t length;
+    std::string fallback;
+
+public:
+    /**
+     * @brief Map a file in memory.
+     *
+     * @param filename Path to the file.
+     * @throws std::runtime_error if the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::string& filename);
+
+    /**
+     * @brief Unmap the file.
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Pointer to the first byte (nullptr for an empty file).
+     */
+    const char* data() const { return this->begin; }
+
+    /**
+     * @brief Size of the file in bytes.
+     */
+    size_t size() const { return this->length; }
+
+    /**
+     * @brief Whole file content as a string_view.
+     */
+    std::string_view view() const { return std::string_view(this->begin, this->length); }
+};
@@ -0,0 +1,316 @@
+// ========================= Sort.cpp =========================
+#include <algorithm>
+#include <numeric>
+#include <cstring>
+#include <type_traits>
+#include <array>
+
+#include "CDataframe.h"
+#include "KeyTable.h"
+#include "ThreadPool.h"
+#include "../Column/ColumnSort.h"
+
+/**
+ * @brief Rows per chunk when building the keys and, at least, per sorted chunk
+ */
+static const size_t SORT_CHUNK_ROWS = 1 << 16;
+
+/**
+ * @brief Bytes of the normalized key held in each SortEntry
+ */
+static const size_t SORT_INLINE_BYTES = 16;
+
+/**
+ * One row to sort: the first 16 bytes of its normalized key as two big-endian
+ * integers, and its stored row number, which locates the rest of the key and
+ * breaks ties.
+ */
+struct SortEntry {
+    uint64_t hi;
+    uint64_t lo;
+    uint32_t row;
+};
+
+/**
+ * Bytes of one sort key inside the normalized key of a row, from `offset`: a
+ * NULL byte if the column has NULLs, then `width` value bytes.
+ */
+struct SortColumn {
+    const ColumnStorage* storage;
+    bool ascending;
+    bool nullable;
+    size_t offset;
+    size_t width;
+
+    /**
+     * @brief Strings: rank of each id (dictionary code, or rowIds entry) among the distinct strings
+     */
+    std::vector<uint32_t> ranks;
+
+    /**
+     * @brief Plain strings: id of the string of each row
+     */
+    std::vector<uint32_t> rowIds;
+};
+
+// Écrit une clé non signée en gros-boutiste : l'ordre des octets suit l'ordre des valeurs
+template <typename K>
+static void putBigEndian(uint8_t* out, K key)
+{
+    for (size_t b = 0; b < sizeof(K); ++b)
+        out[b] = static_cast<uint8_t>(key >> (8 * (sizeof(K) - 1 - b)));
+}
+
+static uint64_t loadBigEndian(const uint8_t* p)
+{
+    uint64_t v = 0;
+    for (size_t b = 0; b < 8; ++b) v = (v << 8) | p[b];
+    return v;
+}
+
+// Rang de chaque chaîne parmi les chaînes distinctes de la colonne, pour des clés de 4 octets
+static void rankStrings(const StringColumn& strings, const ValidityBitmap& validity, SortColumn& col)
+{
+    if (strings.isDictionary()) {
+        col.ranks = strings.sortedRanks();
+        return;
+    }
+
+    StringNumbering numbering;
+    col.rowIds.assign(strings.size(), 0);
+    for (size_t i = 0; i < strings.size(); ++i)
+        if (validity.test(i)) col.rowIds[i] = numbering.insert(strings[i]);
+
+    std::vector<uint32_t> order(numbering.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+        [&numbering](uint32_t a, uint32_t b) { return numbering.at(a) < numbering.at(b); });
+    col.ranks.resize(order.size());
+    for (size_t r = 0; r < order.size(); ++r) col.ranks[order[r]] = static_cast<uint32_t>(r);
+}
+
+// Octets de la colonne dans les clés des lignes [begin, end) (w octets par clé, à partir de keys)
+static void writeSortKeys(const SortColumn& col, size_t begin, size_t end, uint8_t* keys, size_t w)
+{
+    const ValidityBitmap& validity = col.storage->getValidity();
+    const size_t stop = std::min(end, col.storage->size());
+    const uint8_t valid = col.ascending ? 0 : 1;
+
+    col.storage->visit([&](const auto& vec) {
+        using V = std::decay_t<decltype(vec)>;
+        for (size_t i = begin; i < end; ++i) {
+            uint8_t* key = keys + (i - begin) * w + col.offset;
+            if (col.nullable) {
+                // les octets de valeur d'une ligne NULL restent à 0
+                if (i >= stop || !validity.test(i)) {
+                    *key = static_cast<uint8_t>(1 - valid);
+                    continue;
+                }
+                *key++ = valid;
+            }
+            if constexpr (std::is_same_v<V, StringColumn>) {
+                const uint32_t rank = col.ranks[vec.isDictionary() ? vec.getCodes()[i] : col.rowIds[i]];
+                putBigEndian(key, col.ascending ? rank : ~rank);
+            } else if constexpr (std::is_arithmetic_v<typename BufferElement<V>::type>) {
+                const auto k = radixKey(vec[i]);
+                putBigEndian(key, col.ascending ? k : static_cast<decltype(k)>(~k));
+            }
+        }
+    });
+}
+
+// Octet d du couple (hi, lo), d = 0 étant l'octet de poids faible de lo
+static unsigned entryByte(const SortEntry& e, size_t d)
+{
+    return static_cast<unsigned>((d < 8 ? e.lo >> (8 * d) : e.hi >> (8 * (d - 8))) & 0xff);
+}
+
+/**
+ * Stable LSD radix sort of entries on their 16 inline bytes, least
+ * significant byte first; bytes that are the same in every entry are skipped.
+ * Equal keys keep their order, i.e. their row order.
+ */
+static void radixSortEntries(SortEntry* first, SortEntry* last, std::vector<SortEntry>& buffer)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    std::vector<std::array<size_t, 256>> counts(SORT_INLINE_BYTES);
+    for (auto& c : counts) c.fill(0);
+    for (const SortEntry* e = first; e != last; ++e)
+        for (size_t d = 0; d < SORT_INLINE_BYTES; ++d) counts[d][entryByte(*e, d)]++;
+
+    buffer.resize(n);
+    SortEntry* src = first;
+    SortEntry* dst = buffer.data();
+    for (size_t d = 0; d < SORT_INLINE_BYTES; ++d) {
+        std::array<size_t, 256>& c = counts[d];
+        if (n == 0 || c[entryByte(*first, d)] == n) continue;
+
+        size_t pos = 0;
+        for (size_t& v : c) {
+            const size_t count = v;
+            v = pos;
+            pos += count;
+        }
+        for (size_t i = 0; i < n; ++i) dst[c[entryByte(src[i], d)]++] = src[i];
+        std::swap(src, dst);
+    }
+    if (src != first) std::copy(src, src + n, first);
+}
+
+bool CDataframe::sortStored(const std::vector<SortKey>& keys, std::vector<uint32_t>& order,
+                            const ValidityBitmap* selection) const
+{
+    const size_t rows = this->storedRowsCount();
+    if (rows >= NO_ROW) return false;
+
+    // ----- disposition des clés : octet NULL (colonnes ayant des NULL) + valeur par colonne -----
+    std::vector<SortColumn> cols(keys.size());
+    size_t w = 0;
+    for (size_t k = 0; k < keys.size(); ++k) {
+        const Column* found = nullptr;
+        for (const auto& col : this->columns)
+            if (!found && col->getName() == keys[k].column) found = col.get();
+        if (!found || found->getType() == ColumnType::OBJECT) return false;
+
+        SortColumn& col = cols[k];
+        col.storage = &found->getStorage();
+        col.ascending = keys[k].ascending;
+        col.offset = w;
+        col.width = 0;
+        const ValidityBitmap& validity = col.storage->getValidity();
+        col.nullable = col.storage->size() < rows || validity.countValid(0, rows) < rows;
+        col.storage->visit([&col](const auto& vec) {
+            using V = std::decay_t<decltype(vec)>;
+            if constexpr (std::is_same_v<V, StringColumn>) {
+                col.width = sizeof(uint32_t);
+                rankStrings(vec, col.storage->getValidity(), col);
+            } else if constexpr (!std::is_same_v<V, std::monostate>) {
+                col.width = sizeof(typename V::value_type);
+            }
+        });
+        w += (col.nullable ? 1 : 0) + col.width;
+    }
+
+    // 16 octets dans l'entrée, le reste éventuel à part, indexé par ligne
+    w = std::max<size_t>(SORT_INLINE_BYTES, (w + 7) & ~size_t{7});
+    const size_t restWidth = w - SORT_INLINE_BYTES;
+
+    // ----- clés normalisées et entrées des lignes vivantes, par blocs en parallèle -----
+    std::vector<uint8_t> rest(rows * restWidth);
+    std::vector<SortEntry> entries(rows);
+    std::vector<uint8_t> live(rows);
+    const size_t chunks = (rows + SORT_CHUNK_ROWS - 1) / SORT_CHUNK_ROWS;
+    ThreadPool::shared().parallelFor(chunks, [&](size_t c) {
+        const size_t begin = c * SORT_CHUNK_ROWS;
+        const size_t end = std::min(rows, begin + SORT_CHUNK_ROWS);
+        std::vector<uint8_t> block((end - begin) * w, 0);
+        for (const SortColumn& col : cols) writeSortKeys(col, begin, end, block.data(), w);
+
+        for (size_t i = begin; i < end; ++i) {
+            const uint8_t* key = block.data() + (i - begin) * w;
+            entries[i] = {loadBigEndian(key), loadBigEndian(key + 8), static_cast<uint32_t>(i)};
+            if (restWidth) std::memcpy(rest.data() + i * restWidth, key + SORT_INLINE_BYTES, restWidth);
+            live[i] = selection ? selection->test(i) : !this->isDeleted(i);
+        }
+    });
+    if (selection || this->getDeletedRowsCount() > 0) {
+        size_t kept = 0;
+        for (size_t i = 0; i < rows; ++i)
+            if (live[i]) entries[kept++] = entries[i];
+        entries.resize(kept);
+    }
+
+    // les 16 premiers octets départagent presque toujours ; sinon le reste de la clé, puis la ligne (tri stable)
+    const uint8_t* restBytes = rest.data();
+    auto less = [restBytes, restWidth](const SortEntry& a, const SortEntry& b) {
+        if (a.hi != b.hi) return a.hi < b.hi;
+        if (a.lo != b.lo) return a.lo < b.lo;
+        if (restWidth) {
+            const int cmp = std::memcmp(restBytes + a.row * restWidth, restBytes + b.row * restWidth, restWidth);
+            if (cmp != 0) return cmp < 0;
+        }
+        return a.row < b.row;
+    };
+
+    // ----- tri par blocs en parallèle, puis fusions deux à deux -----
+    const size_t n = entries.size();
+    const size_t parts = std::max<size_t>(1, std::min<size_t>(ThreadPool::shared().size(), n / SORT_CHUNK_ROWS));
+    auto bound = [n, parts](size_t p) { return n * std::min(p, parts) / parts; };
+    // clé entière dans l'entrée : tri par base, stable ; sinon tri par comparaisons
+    ThreadPool::shared().parallelFor(parts, [&](size_t p) {
+        if (restWidth == 0) {
+            std::vector<SortEntry> buffer;
+            radixSortEntries(entries.data() + bound(p), entries.data() + bound(p + 1), buffer);
+        } else {
+            std::sort(entries.begin() + bound(p), entries.begin() + bound(p + 1), less);
+        }
+    });
+
+    std::vector<SortEntry> merged(parts > 1 ? n : 0);
+    for (size_t run = 1; run < parts; run *= 2) {
+        const size_t pairs = (parts + 2 * run - 1) / (2 * run);
+        ThreadPool::shared().parallelFor(pairs, [&](size_t q) {
+            const size_t lo = bound(2 * q * run);
+            const size_t mid = bound(2 * q * run + run);
+            const size_t hi = bound(2 * q * run + 2 * run);
+            std::merge(entries.begin() + lo, entries.begin() + mid,
+                       entries.begin() + mid, entries.begin() + hi, merged.begin() + lo, less);
+        });
+        entries.swap(merged);
+    }
+
+    order.resize(n);
+    for (size_t i = 0; i < n; ++i) order[i] = entries[i].row;
+    return true;
+}
+
+bool CDataframe::sortPermutation(const std::vector<SortKey>& keys, std::vector<size_t>& rows) const
+{
+    std::vector<uint32_t> order;
+    if (!this->sortStored(keys, order)) return false;
+
+    // numérotation des lignes vivantes
+    std::vector<uint32_t> liveIndex;
+    if (this->getDeletedRowsCount() > 0) {
+        liveIndex.resize(this->storedRowsCount());
+        uint32_t live = 0;
+        for (size_t i = 0; i < liveIndex.size(); ++i) {
+            liveIndex[i] = live;
+            if (!this->isDeleted(i)) live++;
+        }
+    }
+
+    rows.resize(order.size());
+    for (size_t i = 0; i < order.size(); ++i) rows[i] = liveIndex.empty() ? order[i] : liveIndex[order[i]];
+    return true;
+}
+
+std::unique_ptr<CDataframe> CDataframe::sortBy(const std::vector<SortKey>& keys,
+                                               const std::vector<std::string>& columns) const
+{
+    std::vector<uint32_t> order;
+    if (!this->sortStored(keys, order)) return nullptr;
+    return this->gatherStored(order, columns);
+}
+
+std::unique_ptr<CDataframe> CDataframe::take(const std::vector<size_t>& rows,
+                                             const std::vector<std::string>& columns) const
+{
+    const size_t count = this->getRowsCount();
+    if (count >= NO_ROW) return nullptr;
+
+    // ligne vivante k -> ligne stockée
+    std::vector<uint32_t> stored;
+    if (this->getDeletedRowsCount() > 0) {
+        stored.reserve(count);
+        for (size_t i = 0; i < this->storedRowsCount(); ++i)
+            if (!this->isDeleted(i)) stored.push_back(static_cast<uint32_t>(i));
+    }
+
+    std::vector<uint32_t> picked(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        if (rows[i] >= count) return nullptr;
+        picked[i] = stored.empty() ? static_cast<uint32_t>(rows[i]) : stored[rows[i]];
+    }
+    return this->gatherStored(picked, columns);
+}
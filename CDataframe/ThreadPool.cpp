@@ -0,0 +1,145 @@
+// ========================= ThreadPool.cpp =========================
+#include <memory>
+
+#include "ThreadPool.h"
+
+// vrai pendant l'exécution d'une tâche : un parallelFor imbriqué s'exécute sur place
+static thread_local bool insideTask = false;
+
+static unsigned resolveThreadCount(unsigned threads)
+{
+    if (threads > 0) return threads;
+    const unsigned hw = std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+ThreadPool::ThreadPool(unsigned threads)
+{
+    this->task = nullptr;
+    this->count = 0;
+    this->next = 0;
+    this->generation = 0;
+    this->active = 0;
+    this->stopping = false;
+
+    const unsigned n = resolveThreadCount(threads);
+    this->workers.reserve(n - 1);
+    for (unsigned i = 1; i < n; ++i)
+        this->workers.emplace_back([this]() { this->workerLoop(); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->wake.notify_all();
+    for (auto& w : this->workers) w.join();
+}
+
+unsigned ThreadPool::size() const
+{
+    return static_cast<unsigned>(this->workers.size()) + 1;
+}
+
+void ThreadPool::runTasks()
+{
+    const bool wasInside = insideTask;
+    insideTask = true;
+
+    size_t i;
+    while ((i = this->next.fetch_add(1)) < this->count) {
+        try {
+            (*this->task)(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            if (!this->error) this->error = std::current_exception();
+            // plus aucune tâche ne sera distribuée
+            this->next = this->count;
+        }
+    }
+
+    insideTask = wasInside;
+}
+
+void ThreadPool::workerLoop()
+{
+    size_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->wake.wait(lock, [&]() { return this->stopping || this->generation != seen; });
+            if (this->stopping) return;
+            seen = this->generation;
+        }
+
+        this->runTasks();
+
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (--this->active == 0) this->done.notify_one();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& task)
+{
+    if (count == 0) return;
+
+    if (this->workers.empty() || count == 1 || insideTask) {
+        for (size_t i = 0; i < count; ++i) task(i);
+        return;
+    }
+
+    std::lock_guard<std::mutex> job(this->submit);
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->task = &task;
+        this->count = count;
+        this->next = 0;
+        this->error = nullptr;
+        this->active = this->workers.size();
+        this->generation++;
+    }
+    this->wake.notify_all();
+
+    // le thread appelant participe aussi
+    this->runTasks();
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->done.wait(lock, [&]() { return this->active == 0; });
+        this->task = nullptr;
+        error = this->error;
+        this->error = nullptr;
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+/* -------------------- shared pool -------------------- */
+
+static std::mutex sharedMutex;
+static std::unique_ptr<ThreadPool> sharedPool;
+static unsigned sharedThreads = 0;
+
+ThreadPool& ThreadPool::shared()
+{
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    if (!sharedPool) sharedPool = std::make_unique<ThreadPool>(sharedThreads);
+    return *sharedPool;
+}
+
+void ThreadPool::setSharedThreadCount(unsigned threads)
+{
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    sharedThreads = threads;
+    // recréé au prochain shared() avec la nouvelle taille
+    if (sharedPool && sharedPool->size() != resolveThreadCount(threads))
+        sharedPool.reset();
+}
+
+unsigned ThreadPool::getSharedThreadCount()
+{
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    return sharedPool ? sharedPool->size() : resolveThreadCount(sharedThreads);
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+
+/**
+ * @class ThreadPool
+ * @brief Fixed set of worker threads running indexed tasks in parallel.
+ *
+ * A pool of size N owns N - 1 threads; the thread calling parallelFor works as
+ * the N-th participant, so a pool of size 1 simply runs everything inline.
+ * Tasks are handed out one index at a time from a shared counter, which keeps
+ * every worker busy even when tasks have uneven costs.
+ *
+ * A process-wide pool is available through shared(); its size is set with
+ * setSharedThreadCount (CDataframe::setThreadCount forwards to it).
+ */
+class ThreadPool
+{
+private:
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    /**
+     * @brief Held for the whole duration of a parallelFor call (one job at a time).
+     */
+    std::mutex submit;
+
+    // job en cours
+    const std::function<void(size_t)>* task;
+    size_t count;
+    std::atomic<size_t> next;
+    std::exception_ptr error;
+
+    size_t generation;
+    size_t active;
+    bool stopping;
+
+    void workerLoop();
+
+    /**
+     * @brief Run tasks of the current job until none is left.
+     */
+    void runTasks();
+
+public:
+    /**
+     * @brief Start a pool.
+     *
+     * @param threads Number of participants, caller included (0 = one per hardware thread).
+     */
+    explicit ThreadPool(unsigned threads = 0);
+
+    /**
+     * @brief Stop and join the worker threads.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Number of participants (worker threads + the calling thread).
+     */
+    unsigned size() const;
+
+    /**
+     * @brief Run task(0) ... task(count - 1) on the pool and wait for all of them.
+     *
+     * Calls coming from inside a task (nested parallelism) run inline on the
+     * current thread. If a task throws, the remaining tasks are skipped and the
+     * first exception is rethrown to the caller.
+     *
+     * @param count Number of tasks.
+     * @param task Function called with each task index.
+     */
+    void parallelFor(size_t count, const std::function<void(size_t)>& task);
+
+    /**
+     * @brief Process-wide pool, created on first use.
+     */
+    static ThreadPool& shared();
+
+    /**
+     * @brief Resize the process-wide pool.
+     *
+     * Must not be called while a parallel operation is running.
+     *
+     * @param threads Number of participants (0 = one per hardware thread).
+     */
+    static void setSharedThreadCount(unsigned threads);
+
+    /**
+     * @brief Number of participants of the process-wide pool.
+     */
+    static unsigned getSharedThreadCount();
+};
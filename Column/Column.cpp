@@ -8,85 +8,92 @@
 #include <any>
 #include <limits>
 #include <cstdint>
+#include <cmath>
 
 #include "Column.h"
+#include "ColumnKernels.h"
+#include "ColumnSort.h"
+#include "ColumnCompare.h"
 
 Column::Column(const std::string& colName, ColumnType type)
+    : data(type)
 {
     this->title = colName;
     this->columnType = type;
-    this->data = std::vector<std::optional<ColumnValue>>();
     this->data.reserve(REALLOC_SIZE);
     this->index = std::vector<size_t>();
     this->validIndex = false;
     this->sortAscending = true;
+    this->maintainIndex = false;
+}
+
+bool Column::acceptsValue(const std::optional<ColumnValue>& value) const
+{
+    return this->data.typed([&value](auto col) { return col.accepts(value); });
 }
 
 // column can store all types of ColumnValue
 bool Column::insertValue(std::optional<ColumnValue> value)
 {
-    // check for each enum type
-    if (value.has_value()) {
-        switch (this->columnType) {
-            case ColumnType::NULLVAL:
-                if (!std::holds_alternative<std::monostate>(value.value()))
-                    return false;
-                break;
-            case ColumnType::UINT:
-                if (!std::holds_alternative<uint32_t>(value.value()))
-                    return false;
-                break;
-            case ColumnType::INT:
-                if (!std::holds_alternative<int32_t>(value.value()))
-                    return false;
-                break;
-            case ColumnType::USHORT:
-                if (!std::holds_alternative<uint16_t>(value.value()))
-                    return false;
-                break;
-            case ColumnType::SHORT:
-                if (!std::holds_alternative<int16_t>(value.value()))
-                    return false;
-                break;
-            case ColumnType::ULONG:
-                if (!std::holds_alternative<uint64_t>(value.value()))
-                    return false;
-                break;
-            case ColumnType::LONG:
-                if (!std::holds_alternative<int64_t>(value.value()))
-                    return false;
-                break;
-            case ColumnType::UCHAR:
-                if (!std::holds_alternative<uint8_t>(value.value()))
-                    return false;
-                break;
-            case ColumnType::CHAR:
-                if (!std::holds_alternative<int8_t>(value.value()))
-                    return false;
-                break;
-            case ColumnType::FLOAT:
-                if (!std::holds_alternative<float>(value.value()))
-                    return false;
-                break;
-            case ColumnType::DOUBLE:
-                if (!std::holds_alternative<double>(value.value()))
-                    return false;
-                break;
-            case ColumnType::STRING:
-                if (!std::holds_alternative<std::string>(value.value()))
-                    return false;
-                break;
-            case ColumnType::OBJECT:
-                if (!std::holds_alternative<std::any>(value.value()))
-                    return false;
-                break;
-            default:
-                return false;
-        }
+    const bool ok = this->data.typed([&value](auto col) { return col.insert(std::move(value)); });
+    if (!ok)
+        return false;
+
+    this->indexAppended(data.size() - 1);
+    this->stats.appended(this->data, this->data.size() - 1);
+    if (this->hashIndex) this->hashIndex->insert(this->data, this->data.size() - 1);
+    return true;
+}
+
+bool Column::insertString(std::string_view value)
+{
+    if (!this->data.appendString(value))
+        return false;
+
+    this->indexAppended(data.size() - 1);
+    this->stats.appended(this->data, this->data.size() - 1);
+    if (this->hashIndex) this->hashIndex->insert(this->data, this->data.size() - 1);
+    return true;
+}
+
+void Column::reserve(size_t n)
+{
+    this->data.reserve(n);
+}
+
+bool Column::appendColumn(const Column& other)
+{
+    if (other.columnType != this->columnType)
+        return false;
+    if (&other == this) {
+        Column copy = other;
+        return this->appendColumn(std::move(copy));
     }
 
-    data.push_back(value);
-    validIndex = false;
+    const size_t first = this->data.size();
+    this->data.extend(other.data);
+    this->indexAppended(first);
+    this->stats.appended(this->data, first);
+    if (this->hashIndex)
+        for (size_t row = first; row < this->data.size(); ++row) this->hashIndex->insert(this->data, row);
+    return true;
+}
+
+bool Column::appendColumn(Column&& other)
+{
+    if (other.columnType != this->columnType)
+        return false;
+
+    const size_t first = this->data.size();
+    this->data.extend(std::move(other.data));
+    other.validIndex = false;
+    other.indexDelta.clear();
+    if (other.hashIndex) other.hashIndex->build(other.data);
+    this->indexAppended(first);
+    this->stats.appended(this->data, first, other.stats);
+    if (this->hashIndex)
+        for (size_t row = first; row < this->data.size(); ++row) this->hashIndex->insert(this->data, row);
+    other.stats.invalidate();
     return true;
 }
 
@@ -95,17 +102,56 @@ bool Column::removeValue(const int index)
     if (index < 0 || static_cast<size_t>(index) >= data.size())
         return false;
 
-    data.erase(data.begin() + index);
-    validIndex = false;
+    if (this->hashIndex) this->hashIndex->erase(this->data, static_cast<size_t>(index));
+    this->stats.remove(this->data, static_cast<size_t>(index));
+    data.erase(static_cast<size_t>(index));
+    this->indexRemoved(static_cast<size_t>(index));
+    if (this->hashIndex) this->hashIndex->shiftDown(static_cast<size_t>(index));
     return true;
 }
 
+void Column::removeRows(const ValidityBitmap& removed)
+{
+    const size_t n = this->data.size();
+    auto gone = [&removed](size_t i) { return i < removed.size() && removed.test(i); };
+
+    // l'index trié garde son ordre : on renumérote ses lignes et on retire les supprimées
+    if (this->validIndex) {
+        std::vector<size_t> newRow(n);
+        size_t kept = 0;
+        for (size_t i = 0; i < n; ++i) newRow[i] = gone(i) ? n : kept++;
+
+        auto remap = [&](std::vector<size_t>& rows) {
+            size_t out = 0;
+            for (size_t r : rows)
+                if (newRow[r] != n) rows[out++] = newRow[r];
+            rows.resize(out);
+        };
+        remap(this->index);
+        remap(this->indexDelta);
+    }
+
+    this->data.removeRows(removed);
+    if (this->hashIndex) this->hashIndex->build(this->data);
+    this->stats.invalidate();
+}
+
 std::optional<ColumnValue> Column::getValueAt(int index) const
 {
     if (index < 0 || static_cast<size_t>(index) >= data.size())
         return std::nullopt;
 
-    return data[index];
+    return data.get(static_cast<size_t>(index));
+}
+
+std::optional<std::string_view> Column::getStringAt(int index) const
+{
+    if (this->columnType != ColumnType::STRING || index < 0 || static_cast<size_t>(index) >= data.size())
+        return std::nullopt;
+    if (!data.isValid(static_cast<size_t>(index)))
+        return std::nullopt;
+
+    return data.getString(static_cast<size_t>(index));
 }
 
 int Column::getSize() const
@@ -118,6 +164,11 @@ std::string Column::getName() const
     return this->title;
 }
 
+ColumnType Column::getType() const
+{
+    return this->columnType;
+}
+
 bool Column::setName(const std::string newValue)
 {
     if (newValue.empty())
@@ -132,7 +183,7 @@ void Column::display() const
     for (int i = 0; i < this->getSize(); i++)
     {
         std::cout << "[" << i << "] ";
-        if (this->data[i].has_value())
+        if (this->data.isValid(static_cast<size_t>(i)))
             std::cout << this->valueToString(static_cast<size_t>(i));
         else
             std::cout << "NULL";
@@ -145,79 +196,590 @@ void Column::display() const
 static int compareColumnValues(const ColumnValue& a, const ColumnValue& b)
 {
     return std::visit(
-        [](auto&& va, auto&& vb) -> int {
-            using A = std::decay_t<decltype(va)>;
-            using B = std::decay_t<decltype(vb)>;
-
-            // NULL handling
-            if constexpr (std::is_same_v<A, std::monostate> && std::is_same_v<B, std::monostate>) return 0;
-            if constexpr (std::is_same_v<A, std::monostate>) return -1;
-            if constexpr (std::is_same_v<B, std::monostate>) return 1;
-
-            // string vs string
-            if constexpr (std::is_same_v<A, std::string> && std::is_same_v<B, std::string>) {
-                if (va < vb) return -1;
-                if (va > vb) return 1;
-                return 0;
-            }
+        [](auto&& va, auto&& vb) -> int { return compareScalar(va, vb); },
+        a, b
+    );
+}
 
-            // any is not comparable
-            if constexpr (std::is_same_v<A, std::any> || std::is_same_v<B, std::any>) {
-                return 0;
-            }
+/**
+ * Count with the typed kernels when both the column and the probe are numeric.
+ * The probe, already resolved into the column's domain, gives the kernel
+ * threshold and whether the comparison is strict, so that the result is the
+ * same as comparing every cell of [begin, end) with compareScalar.
+ */
+template <typename T>
+static size_t countNumeric(const T* values, const ValidityBitmap& validity,
+                           size_t begin, size_t end, const ProbeComparator<T>& probe, KernelOp op)
+{
+    const uint64_t* words = validity.raw().data();
+    auto all = [&]() { return validity.countValid(begin, end); };
+    auto run = [&](KernelOp k) { return countMatches(values, words, begin, end, k, probe.threshold); };
 
-            // numeric vs numeric
-            if constexpr (std::is_arithmetic_v<A> && std::is_arithmetic_v<B>) {
-                long double da = static_cast<long double>(va);
-                long double db = static_cast<long double>(vb);
-                if (da < db) return -1;
-                if (da > db) return 1;
-                return 0;
-            }
+    // sonde NaN face à des entiers : tout est égal, rien n'est plus grand ni plus petit
+    if (probe.unordered) return op == KernelOp::EQUAL ? all() : 0;
 
-            // incompatible
+    if (op == KernelOp::EQUAL) {
+        if (probe.atThreshold == 0) return run(KernelOp::EQUAL);
+        // seules les cellules NaN sont "égales" à une sonde absente du type
+        if constexpr (std::is_floating_point_v<T>) return run(KernelOp::UNORDERED);
+        else return 0;
+    }
+    if (op == KernelOp::GREATER)
+        return run(probe.atThreshold > 0 ? KernelOp::GREATER_EQUAL : KernelOp::GREATER);
+    return run(probe.atThreshold < 0 ? KernelOp::LOWER_EQUAL : KernelOp::LOWER);
+}
+
+/**
+ * Count the valid rows of [begin, end) whose comparison with `value` matches
+ * `op` (KernelOp::EQUAL, GREATER or LOWER). The buffer and probe types are
+ * resolved once: numeric pairs go to the vectorized kernels, a string probe
+ * on a dictionary-encoded column is counted on the codes with the same
+ * kernels, pairs that are not comparable (isComparable) count nothing and
+ * other pairs loop on the typed buffer with compareScalar.
+ * Rows set in `deleted` (if any) are skipped like NULL rows.
+ */
+static int countCompared(const ColumnStorage& data, const ColumnValue& value, KernelOp op,
+                         size_t begin, size_t end, const ValidityBitmap* deleted)
+{
+    end = std::min(end, data.size());
+    if (begin >= end) return 0;
+
+    // lignes supprimées dans la plage : on compte sur une copie des mots de validité
+    // qui les exclut, renumérotée depuis le mot de begin (base)
+    size_t base = 0;
+    ValidityBitmap masked;
+    const bool skipDeleted = deleted && deleted->countValid(begin, end) > 0;
+    if (skipDeleted) {
+        masked = data.getValidity().maskedRange(begin, end, *deleted);
+        base = begin / 64 * 64;
+        begin -= base;
+        end -= base;
+    }
+    const ValidityBitmap& validity = skipDeleted ? masked : data.getValidity();
+
+    return data.visit([&](const auto& vec) -> int {
+        using V = std::decay_t<decltype(vec)>;
+        if constexpr (std::is_same_v<V, std::monostate>) {
             return 0;
-        },
-        a, b
-    );
+        } else {
+            return std::visit([&](const auto& probe) -> int {
+                using T = typename V::value_type;
+                using P = std::decay_t<decltype(probe)>;
+
+                if constexpr (std::is_arithmetic_v<T> && std::is_arithmetic_v<P>) {
+                    return static_cast<int>(countNumeric(vec.data() + base, validity, begin, end, ProbeComparator<T>(probe), op));
+                } else if constexpr (!isComparable<T, P>) {
+                    // une chaîne face à un nombre, un objet : aucune ligne n'est égale, plus grande ni plus petite
+                    return 0;
+                } else {
+                    if constexpr (std::is_same_v<V, StringColumn> && std::is_same_v<P, std::string>) {
+                        if (op == KernelOp::EQUAL && vec.isDictionary()) {
+                            // chaîne absente du dictionnaire : aucune ligne ne peut l'égaler
+                            uint32_t code;
+                            if (!vec.findCode(probe, code)) return 0;
+                            return static_cast<int>(countMatches(vec.getCodes().data() + base, validity.raw().data(),
+                                                                 begin, end, KernelOp::EQUAL, code));
+                        }
+                    }
+
+                    int cnt = 0;
+                    for (size_t i = begin; i < end; i++) {
+                        if (!validity.test(i)) continue;
+                        const int cmp = compareScalar(vec[base + i], probe);
+                        if ((op == KernelOp::EQUAL && cmp == 0) ||
+                            (op == KernelOp::GREATER && cmp > 0) ||
+                            (op == KernelOp::LOWER && cmp < 0))
+                            cnt++;
+                    }
+                    return cnt;
+                }
+            }, value);
+        }
+    });
+}
+
+/**
+ * countCompared zone by zone: the zones whose bounds settle the count
+ * (ColumnStats::boundedCount) are not read, the rows between them are
+ * counted in one call. A zone settled to a non-zero count is only trusted
+ * when the range covers it entirely and none of its rows is deleted.
+ */
+static int countZoned(const ColumnStats& stats, const ColumnStorage& data, const ColumnValue& value, KernelOp op,
+                      size_t begin, size_t end, const ValidityBitmap* deleted)
+{
+    end = std::min(end, data.size());
+    if (begin >= end || !stats.isCurrent(data)) return countCompared(data, value, op, begin, end, deleted);
+
+    int total = 0;
+    size_t pending = begin;  // début des lignes à lire
+    for (size_t k = begin / ZONE_ROWS; k * ZONE_ROWS < end; ++k) {
+        const size_t from = std::max(begin, k * ZONE_ROWS);
+        const size_t to = std::min(end, (k + 1) * ZONE_ROWS);
+        const long long settled = ColumnStats::boundedCount(stats.getZone(k), value, op);
+        if (settled < 0) continue;
+        if (settled > 0 && (from != k * ZONE_ROWS || to != std::min(data.size(), (k + 1) * ZONE_ROWS) ||
+                            (deleted && deleted->countValid(from, to) > 0)))
+            continue;
+
+        total += countCompared(data, value, op, pending, from, deleted) + static_cast<int>(settled);
+        pending = to;
+    }
+    return total + countCompared(data, value, op, pending, end, deleted);
+}
+
+/* -------------------- index queries -------------------- */
+
+/**
+ * Layout of a list of rows in index order (the index or its delta) around a
+ * probe, as positions in the list. Comparable rows (neither NULL nor NaN) are
+ * in [begin, end), rows equal to the probe in [lower, upper); the rows before
+ * `lower` are lower than the probe in ascending order, greater in descending
+ * order. NaN rows, which compare equal to anything, are in [nanBegin, nanEnd).
+ * A probe that cannot be compared to the column has every range empty and
+ * `comparable` false.
+ */
+struct IndexBounds {
+    size_t begin;
+    size_t lower;
+    size_t upper;
+    size_t end;
+    size_t nanBegin;
+    size_t nanEnd;
+    bool comparable;
+};
+
+template <typename C, typename P>
+static IndexBounds boundsIn(const std::vector<size_t>& rows, const C& vec,
+                            const ValidityBitmap& validity, const P& probe, bool ascending)
+{
+    using T = typename C::value_type;
+    auto isNull = [&validity](size_t r) { return !validity.test(r); };
+    auto isNaN = [&vec](size_t r) {
+        if constexpr (std::is_floating_point_v<T>) return vec[r] != vec[r];
+        else { (void)r; return false; }
+    };
+
+    IndexBounds b;
+    b.comparable = true;
+    // croissant : [valeurs][NaN][NULL] ; décroissant : [NULL][NaN][valeurs]
+    if (ascending) {
+        const auto nan = std::partition_point(rows.begin(), rows.end(), [&](size_t r) { return !isNull(r) && !isNaN(r); });
+        const auto null = std::partition_point(nan, rows.end(), [&](size_t r) { return !isNull(r); });
+        b.begin = 0;
+        b.end = b.nanBegin = static_cast<size_t>(nan - rows.begin());
+        b.nanEnd = static_cast<size_t>(null - rows.begin());
+    } else {
+        const auto nan = std::partition_point(rows.begin(), rows.end(), isNull);
+        const auto values = std::partition_point(nan, rows.end(), isNaN);
+        b.nanBegin = static_cast<size_t>(nan - rows.begin());
+        b.nanEnd = b.begin = static_cast<size_t>(values - rows.begin());
+        b.end = rows.size();
+    }
+
+    const auto first = rows.begin() + static_cast<std::ptrdiff_t>(b.begin);
+    const auto last = rows.begin() + static_cast<std::ptrdiff_t>(b.end);
+    const auto cmp = probeComparator<T>(probe);
+    const int before = ascending ? -1 : 1;
+    const auto lower = std::partition_point(first, last, [&](size_t r) { return cmp(vec[r]) == before; });
+    const auto upper = std::partition_point(lower, last, [&](size_t r) { return cmp(vec[r]) != -before; });
+    b.lower = static_cast<size_t>(lower - rows.begin());
+    b.upper = static_cast<size_t>(upper - rows.begin());
+    return b;
+}
+
+/**
+ * Call f(rows, bounds) for the index and for the delta.
+ */
+template <typename F>
+static void forEachIndexBounds(const ColumnStorage& data, const std::vector<size_t>& index,
+                               const std::vector<size_t>& delta, bool ascending,
+                               const ColumnValue& value, F&& f)
+{
+    const ValidityBitmap& validity = data.getValidity();
+
+    data.visit([&](const auto& vec) {
+        using V = std::decay_t<decltype(vec)>;
+        for (const std::vector<size_t>* rows : {&index, &delta}) {
+            if constexpr (std::is_same_v<V, std::monostate>) {
+                // que des NULL : aucune ligne comparable
+                const size_t at = ascending ? 0 : rows->size();
+                f(*rows, IndexBounds{at, at, at, at, at, at, true});
+            } else {
+                std::visit([&](const auto& probe) {
+                    using P = std::decay_t<decltype(probe)>;
+                    if constexpr (isComparable<typename V::value_type, P>) {
+                        f(*rows, boundsIn(*rows, vec, validity, probe, ascending));
+                    } else {
+                        // sonde non comparable : aucune ligne avant, égale ni après
+                        f(*rows, IndexBounds{0, 0, 0, 0, 0, 0, false});
+                    }
+                }, value);
+            }
+        }
+    });
+}
+
+bool Column::indexCounts(const ColumnValue& value, size_t& lower, size_t& equal, size_t& greater) const
+{
+    if (!this->validIndex) return false;
+
+    const bool ascending = this->sortAscending;
+    lower = equal = greater = 0;
+    forEachIndexBounds(this->data, this->index, this->indexDelta, ascending, value,
+        [&](const std::vector<size_t>&, const IndexBounds& b) {
+            const size_t before = b.lower - b.begin;
+            const size_t after = b.end - b.upper;
+            lower += ascending ? before : after;
+            greater += ascending ? after : before;
+            equal += (b.upper - b.lower) + (b.nanEnd - b.nanBegin);
+        });
+    return true;
+}
+
+int Column::lowerBound(const ColumnValue& value) const
+{
+    if (!this->validIndex) return -1;
+
+    size_t rank = 0;
+    forEachIndexBounds(this->data, this->index, this->indexDelta, this->sortAscending, value,
+        [&rank](const std::vector<size_t>&, const IndexBounds& b) { rank += b.lower; });
+    return static_cast<int>(rank);
+}
+
+int Column::upperBound(const ColumnValue& value) const
+{
+    if (!this->validIndex) return -1;
+
+    size_t rank = 0;
+    forEachIndexBounds(this->data, this->index, this->indexDelta, this->sortAscending, value,
+        [&rank](const std::vector<size_t>&, const IndexBounds& b) { rank += b.upper; });
+    return static_cast<int>(rank);
+}
+
+/**
+ * Positions [first, last) of the rows lo <= value < hi in a list of rows in
+ * index order, given the bounds of lo and hi in that list.
+ */
+static std::pair<size_t, size_t> rangeIn(const IndexBounds& lo, const IndexBounds& hi, bool ascending)
+{
+    if (!lo.comparable || !hi.comparable) return {0, 0};
+
+    const size_t first = ascending ? lo.lower : hi.upper;
+    const size_t last = ascending ? hi.lower : lo.upper;
+    return {first, std::max(first, last)};
+}
+
+int Column::countInRange(const ColumnValue& lo, const ColumnValue& hi) const
+{
+    if (!this->validIndex) return -1;
+
+    const bool ascending = this->sortAscending;
+    std::vector<IndexBounds> low;
+    forEachIndexBounds(this->data, this->index, this->indexDelta, ascending, lo,
+        [&low](const std::vector<size_t>&, const IndexBounds& b) { low.push_back(b); });
+
+    size_t k = 0;
+    size_t count = 0;
+    forEachIndexBounds(this->data, this->index, this->indexDelta, ascending, hi,
+        [&](const std::vector<size_t>&, const IndexBounds& b) {
+            const auto range = rangeIn(low[k++], b, ascending);
+            count += range.second - range.first;
+        });
+    return static_cast<int>(count);
+}
+
+std::vector<size_t> Column::rowsInRange(const ColumnValue& lo, const ColumnValue& hi) const
+{
+    std::vector<size_t> out;
+    if (!this->validIndex) return out;
+
+    const bool ascending = this->sortAscending;
+    std::vector<IndexBounds> low;
+    forEachIndexBounds(this->data, this->index, this->indexDelta, ascending, lo,
+        [&low](const std::vector<size_t>&, const IndexBounds& b) { low.push_back(b); });
+
+    size_t k = 0;
+    forEachIndexBounds(this->data, this->index, this->indexDelta, ascending, hi,
+        [&](const std::vector<size_t>& rows, const IndexBounds& b) {
+            const auto range = rangeIn(low[k++], b, ascending);
+            out.insert(out.end(), rows.begin() + static_cast<std::ptrdiff_t>(range.first),
+                       rows.begin() + static_cast<std::ptrdiff_t>(range.second));
+        });
+
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+std::vector<size_t> Column::findRows(const ColumnValue& value) const
+{
+    if (this->hashIndex) return this->hashIndex->rows(this->data, value);
+
+    std::vector<size_t> out;
+    if (!this->validIndex) return out;
+
+    forEachIndexBounds(this->data, this->index, this->indexDelta, this->sortAscending, value,
+        [&out](const std::vector<size_t>& rows, const IndexBounds& b) {
+            out.insert(out.end(), rows.begin() + static_cast<std::ptrdiff_t>(b.lower),
+                       rows.begin() + static_cast<std::ptrdiff_t>(b.upper));
+            out.insert(out.end(), rows.begin() + static_cast<std::ptrdiff_t>(b.nanBegin),
+                       rows.begin() + static_cast<std::ptrdiff_t>(b.nanEnd));
+        });
+
+    std::sort(out.begin(), out.end());
+    return out;
 }
 
 int Column::occurence(const ColumnValue& value) const
+{
+    return this->occurence(value, 0, this->data.size());
+}
+
+int Column::occurence(const ColumnValue& value, size_t begin, size_t end, const ValidityBitmap* deleted) const
 {
     if (this->data.empty()) return 0;
 
-    int cnt = 0;
-    for (int i = 0; i < this->getSize(); i++)
-        if (this->data[i].has_value() && compareColumnValues(this->data[i].value(), value) == 0)
-            cnt++;
+    // les index couvrent aussi les lignes supprimées : on ne s'en sert pas s'il y en a
+    const bool wholeColumn = begin == 0 && end >= this->data.size() && (!deleted || deleted->size() == deleted->nullCount());
+    const long long bounded = this->stats.boundedCount(this->data, value, KernelOp::EQUAL);
+    if (bounded == 0 || (bounded > 0 && wholeColumn)) return static_cast<int>(bounded);
+    if (wholeColumn && this->hashIndex)
+        return static_cast<int>(this->hashIndex->count(this->data, value));
 
-    return cnt;
+    size_t lower, equal, greater;
+    if (wholeColumn && this->indexCounts(value, lower, equal, greater))
+        return static_cast<int>(equal);
+
+    return countZoned(this->stats, this->data, value, KernelOp::EQUAL, begin, end, deleted);
 }
 
 int Column::numberGreaterThan(const ColumnValue& value) const
+{
+    return this->numberGreaterThan(value, 0, this->data.size());
+}
+
+int Column::numberGreaterThan(const ColumnValue& value, size_t begin, size_t end, const ValidityBitmap* deleted) const
 {
     if (this->data.empty()) return 0;
     if (this->columnType == ColumnType::STRING || this->columnType == ColumnType::OBJECT) return 0;
 
-    int cnt = 0;
-    for (int i = 0; i < this->getSize(); i++)
-        if (this->data[i].has_value() && compareColumnValues(this->data[i].value(), value) > 0)
-            cnt++;
+    const bool wholeColumn = begin == 0 && end >= this->data.size() && (!deleted || deleted->size() == deleted->nullCount());
+    // sonde au-delà des bornes de la colonne : réponse sans lire une ligne
+    const long long bounded = this->stats.boundedCount(this->data, value, KernelOp::GREATER);
+    if (bounded == 0 || (bounded > 0 && wholeColumn)) return static_cast<int>(bounded);
 
-    return cnt;
+    size_t lower, equal, greater;
+    if (wholeColumn && this->indexCounts(value, lower, equal, greater))
+        return static_cast<int>(greater);
+
+    return countZoned(this->stats, this->data, value, KernelOp::GREATER, begin, end, deleted);
 }
 
 int Column::numberLowerThan(const ColumnValue& value) const
+{
+    return this->numberLowerThan(value, 0, this->data.size());
+}
+
+int Column::numberLowerThan(const ColumnValue& value, size_t begin, size_t end, const ValidityBitmap* deleted) const
 {
     if (this->data.empty()) return 0;
     if (this->columnType == ColumnType::STRING || this->columnType == ColumnType::OBJECT) return 0;
 
-    int cnt = 0;
-    for (int i = 0; i < this->getSize(); i++)
-        if (this->data[i].has_value() && compareColumnValues(this->data[i].value(), value) < 0)
-            cnt++;
+    const bool wholeColumn = begin == 0 && end >= this->data.size() && (!deleted || deleted->size() == deleted->nullCount());
+    // sonde au-delà des bornes de la colonne : réponse sans lire une ligne
+    const long long bounded = this->stats.boundedCount(this->data, value, KernelOp::LOWER);
+    if (bounded == 0 || (bounded > 0 && wholeColumn)) return static_cast<int>(bounded);
+
+    size_t lower, equal, greater;
+    if (wholeColumn && this->indexCounts(value, lower, equal, greater))
+        return static_cast<int>(lower);
+
+    return countZoned(this->stats, this->data, value, KernelOp::LOWER, begin, end, deleted);
+}
+
+/* -------------------- selection -------------------- */
+
+// Bits du mot commençant à la ligne `word` qui tombent dans [begin, end)
+static uint64_t bitRangeOf(size_t begin, size_t end, size_t word)
+{
+    const size_t lo = begin > word ? begin - word : 0;
+    const size_t hi = std::min<size_t>(64, end - word);
+    const uint64_t upTo = hi >= 64 ? ~uint64_t{0} : ((uint64_t{1} << hi) - 1);
+    return upTo & ~((uint64_t{1} << lo) - 1);
+}
+
+/**
+ * Set in `out` (word 0 = word of begin) the valid rows of [begin, end) whose
+ * comparison with `value` matches `op` (KernelOp::EQUAL, GREATER or LOWER),
+ * with the same dispatch as countCompared.
+ * @return false if the value cannot be compared to the column type (no row set)
+ */
+static bool selectCompared(const ColumnStorage& data, const ColumnValue& value, KernelOp op,
+                           size_t begin, size_t end, uint64_t* out)
+{
+    const ValidityBitmap& validity = data.getValidity();
+    const size_t base = begin / 64 * 64;
+
+    return data.visit([&](const auto& vec) -> bool {
+        using V = std::decay_t<decltype(vec)>;
+        if constexpr (std::is_same_v<V, std::monostate>) {
+            return true;
+        } else {
+            return std::visit([&](const auto& probe) -> bool {
+                using T = typename V::value_type;
+                using P = std::decay_t<decltype(probe)>;
+
+                if constexpr (std::is_arithmetic_v<T> && std::is_arithmetic_v<P>) {
+                    const ProbeComparator<T> c(probe);
+                    auto run = [&](KernelOp k) { selectMatches(vec.data(), validity.raw().data(), begin, end, k, c.threshold, out); };
+
+                    // même résolution de la sonde que countNumeric
+                    if (c.unordered) {
+                        if (op == KernelOp::EQUAL)
+                            for (size_t w = 0; base + w * 64 < end; ++w)
+                                out[w] |= validity.raw()[base / 64 + w] & bitRangeOf(begin, end, base + w * 64);
+                    } else if (op == KernelOp::EQUAL) {
+                        if (c.atThreshold == 0) run(KernelOp::EQUAL);
+                        else if constexpr (std::is_floating_point_v<T>) run(KernelOp::UNORDERED);
+                    } else if (op == KernelOp::GREATER) {
+                        run(c.atThreshold > 0 ? KernelOp::GREATER_EQUAL : KernelOp::GREATER);
+                    } else {
+                        run(c.atThreshold < 0 ? KernelOp::LOWER_EQUAL : KernelOp::LOWER);
+                    }
+                    return true;
+                } else if constexpr (!isComparable<T, P>) {
+                    return false;
+                } else {
+                    if constexpr (std::is_same_v<V, StringColumn> && std::is_same_v<P, std::string>) {
+                        if (op == KernelOp::EQUAL && vec.isDictionary()) {
+                            uint32_t code;
+                            if (vec.findCode(probe, code))
+                                selectMatches(vec.getCodes().data(), validity.raw().data(), begin, end, KernelOp::EQUAL, code, out);
+                            return true;
+                        }
+                    }
 
-    return cnt;
+                    auto compare = probeComparator<T>(probe);
+                    for (size_t i = begin; i < end; i++) {
+                        if (!validity.test(i)) continue;
+                        const int cmp = compare(vec[i]);
+                        if ((op == KernelOp::EQUAL && cmp == 0) ||
+                            (op == KernelOp::GREATER && cmp > 0) ||
+                            (op == KernelOp::LOWER && cmp < 0))
+                            out[(i - base) / 64] |= uint64_t{1} << (i & 63);
+                    }
+                    return true;
+                }
+            }, value);
+        }
+    });
+}
+
+/**
+ * Set in `out` (word 0 = word of begin) the rows of [begin, end) matching
+ * the predicate, reading every row of the range.
+ */
+static void selectRows(const ColumnStorage& data, PredicateOp op, const ColumnValue& value, const ColumnValue& upper,
+                       size_t begin, size_t end, uint64_t* out)
+{
+    if (begin >= end) return;
+
+    const size_t base = begin / 64 * 64;
+    const size_t words = (end - base + 63) / 64;
+    const std::vector<uint64_t>& validity = data.getValidity().raw();
+
+    switch (op) {
+        case PredicateOp::EQUAL:
+            selectCompared(data, value, KernelOp::EQUAL, begin, end, out);
+            break;
+        case PredicateOp::LOWER:
+            selectCompared(data, value, KernelOp::LOWER, begin, end, out);
+            break;
+        case PredicateOp::GREATER:
+            selectCompared(data, value, KernelOp::GREATER, begin, end, out);
+            break;
+        case PredicateOp::RANGE: {
+            // [lo, hi) = (< hi) sans (< lo) : une comparaison vaut -1, 0 ou 1, donc ">= lo" est "non < lo"
+            std::vector<uint64_t> belowLo(words, 0), belowHi(words, 0);
+            if (!selectCompared(data, value, KernelOp::LOWER, begin, end, belowLo.data())) break;
+            if (!selectCompared(data, upper, KernelOp::LOWER, begin, end, belowHi.data())) break;
+            for (size_t w = 0; w < words; ++w) out[w] |= belowHi[w] & ~belowLo[w];
+            break;
+        }
+        case PredicateOp::IS_NULL:
+        case PredicateOp::NOT_NULL:
+            for (size_t w = 0; w < words; ++w) {
+                const uint64_t valid = validity[base / 64 + w];
+                out[w] |= (op == PredicateOp::NOT_NULL ? valid : ~valid) & bitRangeOf(begin, end, base + w * 64);
+            }
+            break;
+    }
+}
+
+/**
+ * true if the bounds and counts of a zone of `rows` rows show that none of
+ * them matches the predicate (same comparisons as selectCompared).
+ */
+static bool zoneExcludes(const ColumnStats::Zone& zone, size_t rows, PredicateOp op,
+                         const ColumnValue& value, const ColumnValue& upper)
+{
+    switch (op) {
+        case PredicateOp::EQUAL:
+            return ColumnStats::boundedCount(zone, value, KernelOp::EQUAL) == 0;
+        case PredicateOp::LOWER:
+            return ColumnStats::boundedCount(zone, value, KernelOp::LOWER) == 0;
+        case PredicateOp::GREATER:
+            return ColumnStats::boundedCount(zone, value, KernelOp::GREATER) == 0;
+        case PredicateOp::RANGE: {
+            // rien sous la borne haute, ou toutes les valeurs sous la borne basse (les NaN ne sont dans aucun intervalle)
+            if (ColumnStats::boundedCount(zone, upper, KernelOp::LOWER) == 0) return true;
+            const long long belowLo = ColumnStats::boundedCount(zone, value, KernelOp::LOWER);
+            return belowLo >= 0 && static_cast<size_t>(belowLo) == zone.values;
+        }
+        case PredicateOp::IS_NULL:
+            return zone.nulls == 0;
+        case PredicateOp::NOT_NULL:
+            return zone.nulls == rows;
+    }
+    return false;
+}
+
+void Column::select(PredicateOp op, const ColumnValue& value, const ColumnValue& upper,
+                    size_t begin, size_t end, uint64_t* out) const
+{
+    end = std::min(end, this->data.size());
+    if (begin >= end) return;
+    if (!this->stats.isCurrent(this->data)) {
+        selectRows(this->data, op, value, upper, begin, end, out);
+        return;
+    }
+
+    // zones exclues par leurs bornes : leurs mots restent à zéro ; les autres sont lues d'un seul appel
+    size_t pending = begin;
+    for (size_t k = begin / ZONE_ROWS; k * ZONE_ROWS < end; ++k) {
+        const size_t rows = std::min(this->data.size(), (k + 1) * ZONE_ROWS) - k * ZONE_ROWS;
+        if (!zoneExcludes(this->stats.getZone(k), rows, op, value, upper)) continue;
+
+        const size_t from = std::max(begin, k * ZONE_ROWS);
+        selectRows(this->data, op, value, upper, pending, from, out + (pending / 64 - begin / 64));
+        pending = std::min(end, (k + 1) * ZONE_ROWS);
+    }
+    if (pending < end) selectRows(this->data, op, value, upper, pending, end, out + (pending / 64 - begin / 64));
+}
+
+Column Column::gather(const ValidityBitmap& selected) const
+{
+    Column out(this->title, this->columnType);
+    if (this->isDictionaryEncoded()) out.setDictionaryEncoding(true);
+    out.data.appendSelected(this->data, selected);
+    return out;
+}
+
+Column Column::gather(const std::vector<uint32_t>& rows) const
+{
+    Column out(this->title, this->columnType);
+    if (this->isDictionaryEncoded()) out.setDictionaryEncoding(true);
+    out.data.appendRows(this->data, rows);
+    return out;
 }
 
 int Column::compareValues(const ColumnValue& a, const ColumnValue& b) const
@@ -225,28 +787,65 @@ int Column::compareValues(const ColumnValue& a, const ColumnValue& b) const
     return compareColumnValues(a, b);
 }
 
+/**
+ * Order of Column::sort between two rows: NULLs last when ascending and first
+ * when descending, numeric values by radixKey (the radix argsort order),
+ * other values by compareScalar, equal values by row number.
+ */
+template <typename C>
+static auto sortedRowLess(const C& vec, const ValidityBitmap& validity, bool ascending)
+{
+    using T = typename C::value_type;
+    return [&vec, &validity, ascending](size_t a, size_t b) {
+        const bool aNull = !validity.test(a);
+        const bool bNull = !validity.test(b);
+
+        if (aNull != bNull) return ascending ? bNull : aNull;
+        if (!aNull) {
+            int cmp;
+            if constexpr (std::is_arithmetic_v<T>) {
+                const auto ka = radixKey(vec[a]);
+                const auto kb = radixKey(vec[b]);
+                cmp = (ka > kb) - (ka < kb);
+            } else {
+                cmp = compareScalar(vec[a], vec[b]);
+            }
+            if (cmp != 0) return ascending ? (cmp < 0) : (cmp > 0);
+        }
+        return a < b;
+    };
+}
+
 void Column::sort(bool ascending)
 {
-    if (this->index.empty() || this->index.size() != this->data.size()) {
-        this->index.resize(this->data.size());
-        std::iota(this->index.begin(), this->index.end(), 0);
-    }
+    this->index.resize(this->data.size());
+    std::iota(this->index.begin(), this->index.end(), 0);
+    this->indexDelta.clear();
 
-    std::sort(this->index.begin(), this->index.end(),
-        [this, ascending](size_t a, size_t b) {
-            const bool aNull = !this->data[a].has_value();
-            const bool bNull = !this->data[b].has_value();
+    const ValidityBitmap& validity = this->data.getValidity();
 
-            // NULLs last if ascending, first if descending
-            if (aNull || bNull) {
-                if (aNull && bNull) return false;
-                if (ascending) return !aNull && bNull;
-                return aNull && !bNull;
+    this->data.visit([&](const auto& vec) {
+        using V = std::decay_t<decltype(vec)>;
+        if constexpr (std::is_same_v<V, std::monostate>) {
+            return;
+        } else if constexpr (std::is_arithmetic_v<typename V::value_type>) {
+            // types numériques à largeur fixe : tri par base, sans comparateur
+            radixArgsort(vec.data(), validity.raw().data(), vec.size(), ascending, this->index);
+        } else if constexpr (std::is_same_v<V, StringColumn>) {
+            if (vec.isDictionary()) {
+                // rang de chaque code dans le dictionnaire trié, puis tri par base sur les rangs
+                const std::vector<uint32_t> rank = vec.sortedRanks();
+                const std::vector<uint32_t>& codes = vec.getCodes();
+                std::vector<uint32_t> keys(codes.size());
+                for (size_t i = 0; i < codes.size(); ++i) keys[i] = rank[codes[i]];
+                radixArgsort(keys.data(), validity.raw().data(), keys.size(), ascending, this->index);
+            } else {
+                std::sort(this->index.begin(), this->index.end(), sortedRowLess(vec, validity, ascending));
             }
-
-            int cmp = compareColumnValues(this->data[a].value(), this->data[b].value());
-            return ascending ? (cmp < 0) : (cmp > 0);
-        });
+        } else {
+            std::sort(this->index.begin(), this->index.end(), sortedRowLess(vec, validity, ascending));
+        }
+    });
 
     this->validIndex = true;
     this->sortAscending = ascending;
@@ -256,11 +855,13 @@ void Column::printSorted(bool ascending)
 {
     if (!this->validIndex || this->sortAscending != ascending)
         this->sort(ascending);
+    else
+        this->mergeIndexDelta();
 
     for (size_t i = 0; i < this->index.size(); i++) {
         size_t idx = this->index[i];
         std::cout << "[" << idx << "] ";
-        if (this->data[idx].has_value())
+        if (this->data.isValid(idx))
             std::cout << this->valueToString(idx);
         else
             std::cout << "NULL";
@@ -271,6 +872,7 @@ void Column::printSorted(bool ascending)
 void Column::eraseIndex()
 {
     this->validIndex = false;
+    this->indexDelta.clear();
 }
 
 int Column::checkIndex() const
@@ -286,40 +888,202 @@ void Column::updateIndex()
     else this->sort(this->sortAscending);
 }
 
-int Column::searchValue(const ColumnValue& val) const
+void Column::setIndexMaintenance(bool enabled)
 {
-    if (!this->validIndex) return -1;
+    if (!enabled) this->mergeIndexDelta();
+    this->maintainIndex = enabled;
+}
 
-    size_t left = 0;
-    size_t right = this->index.size();
+bool Column::getIndexMaintenance() const
+{
+    return this->maintainIndex;
+}
 
-    while (left < right) {
-        size_t mid = left + (right - left) / 2;
-        size_t idx = this->index[mid];
+void Column::buildHashIndex()
+{
+    this->hashIndex.emplace();
+    this->hashIndex->build(this->data);
+}
 
-        if (!this->data[idx].has_value()) {
-            if (this->sortAscending) right = mid;
-            else left = mid + 1;
-            continue;
+void Column::dropHashIndex()
+{
+    this->hashIndex.reset();
+}
+
+bool Column::hasHashIndex() const
+{
+    return this->hashIndex.has_value();
+}
+
+void Column::refreshStatistics()
+{
+    this->stats.refresh(this->data, false);
+}
+
+bool Column::hasCurrentStatistics() const
+{
+    return this->stats.isCurrent(this->data);
+}
+
+const ColumnStats& Column::getStatistics()
+{
+    this->stats.refresh(this->data);
+    return this->stats;
+}
+
+bool Column::setDictionaryEncoding(bool enabled)
+{
+    return this->data.visit([enabled](auto& vec) -> bool {
+        using V = std::decay_t<decltype(vec)>;
+        if constexpr (std::is_same_v<V, StringColumn>) {
+            if (enabled) vec.encodeDictionary();
+            else vec.decodeDictionary();
+            return true;
+        } else {
+            return false;
+        }
+    });
+}
+
+bool Column::isDictionaryEncoded() const
+{
+    return this->data.visit([](const auto& vec) -> bool {
+        using V = std::decay_t<decltype(vec)>;
+        if constexpr (std::is_same_v<V, StringColumn>) return vec.isDictionary();
+        else return false;
+    });
+}
+
+void Column::optimizeStringEncoding()
+{
+    this->data.visit([](auto& vec) {
+        using V = std::decay_t<decltype(vec)>;
+        if constexpr (std::is_same_v<V, StringColumn>) {
+            if (vec.cardinality() * DICTIONARY_MAX_RATIO <= vec.size()) vec.encodeDictionary();
+            else vec.decodeDictionary();
         }
+    });
+}
 
-        int cmp = compareColumnValues(this->data[idx].value(), val);
-        if (cmp == 0) return 1;
-        if (cmp < 0) left = mid + 1;
-        else right = mid;
+void Column::indexAppended(size_t first)
+{
+    if (!this->validIndex) return;
+    if (!this->maintainIndex) {
+        this->validIndex = false;
+        return;
     }
 
-    return 0;
+    const ValidityBitmap& validity = this->data.getValidity();
+    const size_t old = this->indexDelta.size();
+    for (size_t row = first; row < this->data.size(); ++row)
+        this->indexDelta.push_back(row);
+
+    // nouvelles lignes triées (k log k), puis fusionnées avec le reste du delta
+    this->data.visit([&](const auto& vec) {
+        using V = std::decay_t<decltype(vec)>;
+        if constexpr (!std::is_same_v<V, std::monostate>) {
+            auto less = sortedRowLess(vec, validity, this->sortAscending);
+            auto mid = this->indexDelta.begin() + static_cast<std::ptrdiff_t>(old);
+            std::sort(mid, this->indexDelta.end(), less);
+            std::inplace_merge(this->indexDelta.begin(), mid, this->indexDelta.end(), less);
+        }
+    });
+
+    if (this->indexDelta.size() >= INDEX_DELTA_MAX)
+        this->mergeIndexDelta();
 }
 
-bool Column::exist(const ColumnValue& value)
+void Column::indexRemoved(size_t row)
 {
-    if (!this->validIndex) {
-        for (const auto& cell : data)
-            if (cell.has_value() && compareColumnValues(cell.value(), value) == 0)
-                return true;
-        return false;
+    if (!this->validIndex) return;
+    if (!this->maintainIndex) {
+        this->validIndex = false;
+        return;
     }
+
+    // on retire la ligne, les lignes suivantes descendent d'un rang : l'ordre ne change pas
+    auto patch = [row](std::vector<size_t>& rows) {
+        rows.erase(std::remove(rows.begin(), rows.end(), row), rows.end());
+        for (size_t& r : rows)
+            if (r > row) r--;
+    };
+    patch(this->index);
+    patch(this->indexDelta);
+}
+
+void Column::indexReplaced(size_t row)
+{
+    if (!this->validIndex) return;
+    if (!this->maintainIndex) {
+        this->validIndex = false;
+        return;
+    }
+
+    // la ligne quitte sa place et repasse par le delta avec sa nouvelle valeur
+    this->index.erase(std::remove(this->index.begin(), this->index.end(), row), this->index.end());
+    this->indexDelta.erase(std::remove(this->indexDelta.begin(), this->indexDelta.end(), row), this->indexDelta.end());
+
+    const ValidityBitmap& validity = this->data.getValidity();
+    this->data.visit([&](const auto& vec) {
+        using V = std::decay_t<decltype(vec)>;
+        if constexpr (!std::is_same_v<V, std::monostate>) {
+            auto pos = std::lower_bound(this->indexDelta.begin(), this->indexDelta.end(), row,
+                                        sortedRowLess(vec, validity, this->sortAscending));
+            this->indexDelta.insert(pos, row);
+        } else {
+            this->indexDelta.push_back(row);
+        }
+    });
+
+    if (this->indexDelta.size() >= INDEX_DELTA_MAX)
+        this->mergeIndexDelta();
+}
+
+void Column::mergeIndexDelta()
+{
+    if (this->indexDelta.empty()) return;
+
+    std::vector<size_t> merged(this->index.size() + this->indexDelta.size());
+    const ValidityBitmap& validity = this->data.getValidity();
+
+    this->data.visit([&](const auto& vec) {
+        using V = std::decay_t<decltype(vec)>;
+        if constexpr (std::is_same_v<V, std::monostate>) {
+            std::merge(this->index.begin(), this->index.end(),
+                       this->indexDelta.begin(), this->indexDelta.end(), merged.begin());
+        } else {
+            std::merge(this->index.begin(), this->index.end(),
+                       this->indexDelta.begin(), this->indexDelta.end(), merged.begin(),
+                       sortedRowLess(vec, validity, this->sortAscending));
+        }
+    });
+
+    this->index.swap(merged);
+    this->indexDelta.clear();
+}
+
+int Column::searchValue(const ColumnValue& val) const
+{
+    if (!this->validIndex) return -1;
+
+    // mêmes bornes que occurence et findRows : une cellule NaN est égale à toute sonde comparable
+    bool found = false;
+    forEachIndexBounds(this->data, this->index, this->indexDelta, this->sortAscending, val,
+        [&found](const std::vector<size_t>&, const IndexBounds& b) {
+            if (b.upper > b.lower || b.nanEnd > b.nanBegin) found = true;
+        });
+    return found ? 1 : 0;
+}
+
+bool Column::exist(const ColumnValue& value)
+{
+    this->refreshStatistics();
+    const long long bounded = this->stats.boundedCount(this->data, value, KernelOp::EQUAL);
+    if (bounded >= 0) return bounded > 0;
+    if (this->hashIndex)
+        return this->hashIndex->count(this->data, value) > 0;
+    if (!this->validIndex)
+        return countZoned(this->stats, this->data, value, KernelOp::EQUAL, 0, this->data.size(), nullptr) > 0;
     return this->searchValue(value) == 1;
 }
 
@@ -327,149 +1091,98 @@ bool Column::accessReplaceValue(int row, std::optional<ColumnValue> newValue)
 {
     if (row < 0 || static_cast<size_t>(row) >= this->data.size())
         return false;
+    if (!this->acceptsValue(newValue))
+        return false;
 
-    this->data[row] = newValue;
-    this->validIndex = false;
+    if (this->hashIndex) this->hashIndex->erase(this->data, static_cast<size_t>(row));
+    this->stats.replacing(this->data, static_cast<size_t>(row));
+    this->data.set(static_cast<size_t>(row), std::move(newValue));
+    this->indexReplaced(static_cast<size_t>(row));
+    if (this->hashIndex) this->hashIndex->insert(this->data, static_cast<size_t>(row));
+    this->stats.replaced(this->data, static_cast<size_t>(row));
     return true;
 }
 
 std::string Column::valueToString(size_t i) const
 {
-    // Petit helper: conversion en string (pour colonne STRING)
-    auto toString = [](const ColumnValue& x) -> std::string {
-        return std::visit([](auto&& arg) -> std::string {
-            using T = std::decay_t<decltype(arg)>;
-
-            if constexpr (std::is_same_v<T, std::monostate>) {
-                return "NULL";
-            } else if constexpr (std::is_same_v<T, std::string>) {
-                return arg;
-            } else if constexpr (std::is_same_v<T, std::any>) {
-                return "[object]";
-            } else if constexpr (std::is_same_v<T, std::uint8_t> || std::is_same_v<T, std::int8_t>) {
-                // éviter l'affichage en caractère
-                return std::to_string(static_cast<int>(arg));
-            } else if constexpr (std::is_arithmetic_v<T>) {
-                return std::to_string(arg);
-            } else {
-                return "[unsupported]";
-            }
-        }, x);
-    };
+    if (i >= this->data.size() || !this->data.isValid(i)) return "NULL";
 
-    if (!data[i].has_value()) return "NULL";
+    return this->data.typed([i](auto col) { return col.toString(i); });
+}
 
-    return std::visit([](auto&& arg) -> std::string {
-        using T = std::decay_t<decltype(arg)>;
+void Column::writeValue(std::ostream& out, size_t i) const
+{
+    if (i >= this->data.size() || !this->data.isValid(i)) {
+        out << "NULL";
+        return;
+    }
 
-        if constexpr (std::is_same_v<T, std::monostate>) {
-            return "NULL";
-        } else if constexpr (std::is_same_v<T, std::string>) {
-            return arg;
-        } else if constexpr (std::is_same_v<T, std::any>) {
-            return "[object]";
-        } else if constexpr (std::is_same_v<T, std::uint8_t> || std::is_same_v<T, std::int8_t>) {
-            return std::to_string(static_cast<int>(arg));
-        } else {
-            return std::to_string(arg);
-        }
-    }, data[i].value());
+    // chaîne : écrite depuis le stockage (le dictionnaire si la colonne est encodée)
+    this->data.typed([&out, i](auto col) { col.write(out, i); });
+}
+
+void Column::writeBinary(std::ostream& out) const
+{
+    this->data.writeBinary(out);
+}
+
+bool Column::readBinary(const char*& p, const char* end, size_t rows)
+{
+    if (!this->data.readBinary(p, end, rows))
+        return false;
+
+    this->index.clear();
+    this->indexDelta.clear();
+    this->validIndex = false;
+    if (this->hashIndex) this->hashIndex->build(this->data);
+    this->stats.invalidate();
+    return true;
 }
 
 bool Column::insertValueAuto(const ColumnValue& v)
 {
-    // NULL accepté partout
-    if (std::holds_alternative<std::monostate>(v))
-        return insertValue(std::nullopt);
-
-    auto toString = [](const ColumnValue& x) -> std::string {
-        return std::visit([](auto&& arg) -> std::string {
-            using T = std::decay_t<decltype(arg)>;
-
-            if constexpr (std::is_same_v<T, std::monostate>) {
-                return "NULL";
-            } else if constexpr (std::is_same_v<T, std::string>) {
-                return arg;
-            } else if constexpr (std::is_same_v<T, std::any>) {
-                return "[object]";
-            } else if constexpr (std::is_same_v<T, std::uint8_t> || std::is_same_v<T, std::int8_t>) {
-                return std::to_string(static_cast<int>(arg));
-            } else if constexpr (std::is_arithmetic_v<T>) {
-                return std::to_string(arg);
-            } else {
-                return "[unsupported]";
-            }
-        }, x);
-    };
+    const bool ok = this->data.typed([&v](auto col) { return col.insertAuto(v); });
+    if (!ok)
+        return false;
 
+    this->indexAppended(data.size() - 1);
+    this->stats.appended(this->data, this->data.size() - 1);
+    if (this->hashIndex) this->hashIndex->insert(this->data, this->data.size() - 1);
+    return true;
+}
 
-    auto toNumber = [](const ColumnValue& x) -> std::optional<long double> {
-        return std::visit([](auto&& arg) -> std::optional<long double> {
-            using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, std::monostate> || std::is_same_v<T, std::string> || std::is_same_v<T, std::any>)
-                return std::nullopt;
-            if constexpr (std::is_arithmetic_v<T>)
-                return static_cast<long double>(arg);
-            return std::nullopt;
-        }, x);
-    };
+template <typename Get>
+bool Column::insertBatchAuto(size_t n, Get value)
+{
+    const size_t first = this->data.size();
+    const bool ok = this->data.appendBatch([n, &value](auto& vec, ValidityBitmap& rows) {
+        using V = std::decay_t<decltype(vec)>;
+        rows.reserve(n);
+        if constexpr (!std::is_same_v<V, std::monostate>) vec.reserve(vec.size() + n);
 
-    switch (this->columnType) {
-        case ColumnType::NULLVAL:
-            return false;
+        // la vue n'écrit qu'en fin de buffer : ses lignes nouvelles vont dans rows
+        TypedColumn<typename BufferElement<V>::type> col(vec, rows);
+        for (size_t i = 0; i < n; ++i)
+            if (!col.insertAuto(value(i))) return false;
+        return true;
+    });
+    if (!ok) return false;
 
-        case ColumnType::OBJECT: {
-            if (std::holds_alternative<std::any>(v))
-                return insertValue(std::optional<ColumnValue>(v));
-            return insertValue(std::optional<ColumnValue>(ColumnValue(std::any(v))));
-        }
+    this->indexAppended(first);
+    this->stats.appended(this->data, first);
+    if (this->hashIndex)
+        for (size_t row = first; row < this->data.size(); ++row) this->hashIndex->insert(this->data, row);
+    return true;
+}
 
-        case ColumnType::STRING: {
-            std::string s = toString(v);
-            return insertValue(std::optional<ColumnValue>(ColumnValue(std::move(s))));
-        }
+bool Column::insertValuesAuto(const std::vector<ColumnValue>& values)
+{
+    return this->insertBatchAuto(values.size(), [&values](size_t i) -> const ColumnValue& { return values[i]; });
+}
 
-        case ColumnType::INT: {
-            auto n = toNumber(v); if (!n) return false;
-            return insertValue(std::optional<ColumnValue>(ColumnValue(static_cast<int32_t>(*n))));
-        }
-        case ColumnType::UINT: {
-            auto n = toNumber(v); if (!n) return false;
-            return insertValue(std::optional<ColumnValue>(ColumnValue(static_cast<uint32_t>(*n))));
-        }
-        case ColumnType::SHORT: {
-            auto n = toNumber(v); if (!n) return false;
-            return insertValue(std::optional<ColumnValue>(ColumnValue(static_cast<int16_t>(*n))));
-        }
-        case ColumnType::USHORT: {
-            auto n = toNumber(v); if (!n) return false;
-            return insertValue(std::optional<ColumnValue>(ColumnValue(static_cast<uint16_t>(*n))));
-        }
-        case ColumnType::LONG: {
-            auto n = toNumber(v); if (!n) return false;
-            return insertValue(std::optional<ColumnValue>(ColumnValue(static_cast<int64_t>(*n))));
-        }
-        case ColumnType::ULONG: {
-            auto n = toNumber(v); if (!n) return false;
-            return insertValue(std::optional<ColumnValue>(ColumnValue(static_cast<uint64_t>(*n))));
-        }
-        case ColumnType::CHAR: {
-            auto n = toNumber(v); if (!n) return false;
-            return insertValue(std::optional<ColumnValue>(ColumnValue(static_cast<int8_t>(*n))));
-        }
-        case ColumnType::UCHAR: {
-            auto n = toNumber(v); if (!n) return false;
-            return insertValue(std::optional<ColumnValue>(ColumnValue(static_cast<uint8_t>(*n))));
-        }
-        case ColumnType::FLOAT: {
-            auto n = toNumber(v); if (!n) return false;
-            return insertValue(std::optional<ColumnValue>(ColumnValue(static_cast<float>(*n))));
-        }
-        case ColumnType::DOUBLE: {
-            auto n = toNumber(v); if (!n) return false;
-            return insertValue(std::optional<ColumnValue>(ColumnValue(static_cast<double>(*n))));
-        }
-        default:
-            return false;
-    }
+bool Column::insertValuesAuto(const std::vector<std::vector<ColumnValue>>& rows, size_t field)
+{
+    for (const auto& row : rows)
+        if (field >= row.size()) return false;
+    return this->insertBatchAuto(rows.size(), [&rows, field](size_t i) -> const ColumnValue& { return rows[i][field]; });
 }
@@ -2,9 +2,13 @@
 #define COLUMNS_H
 
 #include "ColumnValue.h"
+#include "ColumnStorage.h"
+#include "ColumnHashIndex.h"
+#include "ColumnStats.h"
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <optional>
 #include <algorithm>
 #include <numeric>
@@ -12,6 +16,29 @@
 
 const size_t REALLOC_SIZE = 256;
 
+/**
+ * @brief Row number standing for "no row" in the row lists given to Column::gather (a NULL row)
+ */
+const uint32_t NO_ROW = 0xffffffffu;
+
+/**
+ * @brief Maximum number of rows kept in the index delta before it is merged into the index
+ */
+const size_t INDEX_DELTA_MAX = 4096;
+
+
+/**
+ * @enum PredicateOp
+ * @brief Test applied to every row by Column::select, comparing as compareScalar does.
+ */
+enum class PredicateOp {
+    EQUAL,    /**< Equal to the value (a NaN cell is equal to anything) */
+    LOWER,    /**< Strictly lower than the value */
+    GREATER,  /**< Strictly greater than the value */
+    RANGE,    /**< In [value, upper) */
+    IS_NULL,  /**< NULL row */
+    NOT_NULL  /**< Row holding a value */
+};
 
 /**
  * @brief Column class for storing integer values
@@ -19,12 +46,32 @@ const size_t REALLOC_SIZE = 256;
 class Column {
 private:
     std::string title;
-    std::vector<std::optional<ColumnValue>> data;
+    ColumnStorage data;
     std::vector<size_t> index;
     ColumnType columnType;
     bool validIndex;
     bool sortAscending;
 
+    /**
+     * @brief Index maintenance mode: the index follows insertions, removals and replacements
+     */
+    bool maintainIndex;
+
+    /**
+     * @brief Rows not merged into the index yet, in index order (only with maintainIndex)
+     */
+    std::vector<size_t> indexDelta;
+
+    /**
+     * @brief Optional hash index (value -> rows), see buildHashIndex
+     */
+    std::optional<ColumnHashIndex> hashIndex;
+
+    /**
+     * @brief Bounds, counts and distinct sketch of the values, see getStatistics
+     */
+    ColumnStats stats;
+
     /**
      * @brief Compare two values
      * @param a First value
@@ -33,6 +80,46 @@ private:
      */
     int compareValues(const ColumnValue& a, const ColumnValue& b) const;
 
+    /**
+     * @brief Check that a value can be stored in this column
+     * @param value The value to check (std::nullopt is always accepted)
+     * @return true if the value matches the column type, false otherwise
+     */
+    bool acceptsValue(const std::optional<ColumnValue>& value) const;
+
+    /**
+     * @brief Update the index after rows [first, size) were appended
+     * Invalidates the index, or adds the rows to the delta in maintenance mode.
+     */
+    void indexAppended(size_t first);
+
+    /**
+     * @brief Update the index after a row was removed (row numbers above it shift down)
+     */
+    void indexRemoved(size_t row);
+
+    /**
+     * @brief Update the index after the value of a row was replaced
+     */
+    void indexReplaced(size_t row);
+
+    /**
+     * @brief Merge the delta into the index, in O(n + k)
+     */
+    void mergeIndexDelta();
+
+    /**
+     * @brief Append `n` values (`value(i)` is the i-th), shared by both insertValuesAuto
+     */
+    template <typename Get>
+    bool insertBatchAuto(size_t n, Get value);
+
+    /**
+     * @brief Count the valid rows lower than, equal to and greater than a value with the index, in O(log n)
+     * @return false if the index is not valid (nothing is counted)
+     */
+    bool indexCounts(const ColumnValue& value, size_t& lower, size_t& equal, size_t& greater) const;
+
 public:
     /**
      * @brief Constructor - create a column
@@ -53,6 +140,33 @@ public:
     */
     bool insertValue(std::optional<ColumnValue> value);
 
+    /**
+    * @brief: Insert a string into a STRING column without building a ColumnValue
+    * @param value : The string, copied straight into the column storage
+    * @return: true if the value is correctly inserted, false if the column is not a STRING column
+    */
+    bool insertString(std::string_view value);
+
+    /**
+     * @brief Reserve room for a given number of values
+     * @param n Expected number of values in the column
+     */
+    void reserve(size_t n);
+
+    /**
+     * @brief Append all the values of another column at the end of this one
+     * @param other A column of the same type
+     * @return true if the values were appended, false if the types differ
+     */
+    bool appendColumn(const Column& other);
+
+    /**
+     * @brief Append all the values of another column, moving them out of it
+     * @param other A column of the same type, left empty on success
+     * @return true if the values were appended, false if the types differ
+     */
+    bool appendColumn(Column&& other);
+
     /**
      * @brief : remove a value  to a given index
      * @param index : the index of the value to remove
@@ -60,12 +174,30 @@ public:
      */
     bool removeValue(const int index);
 
+    /**
+     * @brief Remove many rows in one linear pass
+     *
+     * The sorted index stays valid (its rows are renumbered) and the hash index
+     * is rebuilt, instead of being patched once per row like with removeValue.
+     *
+     * @param removed Rows to remove (bit set); rows past its end are kept
+     */
+    void removeRows(const ValidityBitmap& removed);
+
     /**
      * @brief Retrieves the  value (or null) at a specified index
      * @param index The zero-based index position
      * @return The optional<ColumnValue> at the specified index, or std::nullopt if index out of range
      */
     std::optional<ColumnValue> getValueAt(int index) const;
+
+    /**
+     * @brief Retrieves the string at a specified index of a STRING column, without copying it
+     * @param index The zero-based index position
+     * @return A view on the string (valid until the column is modified), or std::nullopt if
+     *         the value is NULL, the index out of range or the column not a STRING column
+     */
+    std::optional<std::string_view> getStringAt(int index) const;
     /**
      * @brief Returns the number of elements currently stored in the column
      * @return The size of the data vector
@@ -78,6 +210,17 @@ public:
      */
     std::string getName() const;
 
+    /**
+     * @brief Retrieves the logical type of the column
+     * @return The ColumnType given at construction
+     */
+    ColumnType getType() const;
+
+    /**
+     * @brief Read access to the typed storage, for operations that dispatch on the element type themselves
+     */
+    const ColumnStorage& getStorage() const { return this->data; }
+
     /**
      * @brief Sets a new title/name for the column
      * @param newName The new name to assign to the column
@@ -93,11 +236,27 @@ public:
 
     /**
      * @brief Counts the number of occurrences of a specified value in the column
+     * Uses the hash index in O(1) if present, then the sorted index in O(log n)
+     * when checkIndex() == 1 (also for numberGreaterThan and numberLowerThan),
+     * and scans the column otherwise.
+     * Numbers compare exactly whatever their types (see compareScalar); a probe
+     * that cannot be compared to the column type, like a string against
+     * numbers, matches no row.
      * @param value The integer value to search for
      * @return The count of how many times the value appears in the column
      */
     int occurence(const ColumnValue& value) const;
 
+    /**
+     * @brief Counts the occurrences of a value among the rows [begin, end)
+     * @param value The value to search for
+     * @param begin First row of the range
+     * @param end One past the last row of the range (clamped to the column size)
+     * @param deleted Optional rows to ignore (bit set), e.g. the rows deleted from a CDataframe
+     * @return The count of how many times the value appears in the range
+     */
+    int occurence(const ColumnValue& value, size_t begin, size_t end, const ValidityBitmap* deleted = nullptr) const;
+
     /**
      * @brief Counts the number of elements greater than a specified value
      * @param value The threshold value for comparison
@@ -105,6 +264,16 @@ public:
      */
     int numberGreaterThan(const ColumnValue& value) const;
 
+    /**
+     * @brief Counts the elements of the rows [begin, end) greater than a value
+     * @param value The threshold value for comparison
+     * @param begin First row of the range
+     * @param end One past the last row of the range (clamped to the column size)
+     * @param deleted Optional rows to ignore (bit set), e.g. the rows deleted from a CDataframe
+     * @return The count of elements greater than value in the range
+     */
+    int numberGreaterThan(const ColumnValue& value, size_t begin, size_t end, const ValidityBitmap* deleted = nullptr) const;
+
 
     /**
      * @brief Counts the number of elements lower than a specified value
@@ -113,8 +282,20 @@ public:
      */
     int numberLowerThan(const ColumnValue& value) const;
 
+    /**
+     * @brief Counts the elements of the rows [begin, end) lower than a value
+     * @param value The threshold value for comparison
+     * @param begin First row of the range
+     * @param end One past the last row of the range (clamped to the column size)
+     * @param deleted Optional rows to ignore (bit set), e.g. the rows deleted from a CDataframe
+     * @return The count of elements lower than value in the range
+     */
+    int numberLowerThan(const ColumnValue& value, size_t begin, size_t end, const ValidityBitmap* deleted = nullptr) const;
+
     /**
      * @brief Sort a column according to a given order
+     * Numeric columns use a stable radix argsort (equal values keep their row
+     * order); STRING and OBJECT columns are sorted with comparisons.
      * @param ascending : true for ascending, false for descending
      */
     void sort(bool ascending = true);
@@ -143,8 +324,98 @@ public:
      */
     void updateIndex();
 
+    /**
+     * @brief Enable or disable the index maintenance mode
+     *
+     * While enabled, a valid index stays valid: appended rows are kept in a
+     * small sorted delta that is merged into the index once it holds
+     * INDEX_DELTA_MAX rows, removed and replaced rows are patched in place.
+     * searchValue looks into both the index and the delta.
+     * When disabled (the default), any modification invalidates the index.
+     *
+     * @param enabled true to maintain the index, false otherwise
+     */
+    void setIndexMaintenance(bool enabled);
+
+    /**
+     * @brief Check whether the index maintenance mode is enabled
+     */
+    bool getIndexMaintenance() const;
+
+    /**
+     * @brief Build (or rebuild) the hash index of the column
+     *
+     * The hash index maps every value to the rows holding it. Once built, it is
+     * kept up to date by insertValue, appendColumn, removeValue and
+     * accessReplaceValue, and exist, occurence and findRows answer equality
+     * lookups from it in O(1), whatever the state of the sorted index.
+     */
+    void buildHashIndex();
+
+    /**
+     * @brief Remove the hash index of the column
+     */
+    void dropHashIndex();
+
+    /**
+     * @brief Check whether the column has a hash index
+     */
+    bool hasHashIndex() const;
+
+    /**
+     * @brief Rebuild the bounds, counts and zone map that a removal, a rewrite or a gather left stale
+     *
+     * Appends keep the statistics current as they write. occurence,
+     * numberGreaterThan, numberLowerThan and select (const, and run on
+     * several threads by CDataframe) use them while they are current: they
+     * then skip the zones of ZONE_ROWS rows whose bounds rule out any match.
+     * exist and the CDataframe counts refresh them first; filters, being
+     * const, scan every row of a column whose statistics are stale. The
+     * distinct estimate is left to getStatistics.
+     */
+    void refreshStatistics();
+
+    /**
+     * @brief true if the statistics cover every row, so that the counts can use them without a refresh
+     */
+    bool hasCurrentStatistics() const;
+
+    /**
+     * @brief Current statistics of the column: min / max, counts, zones, distinct estimate (refreshed first)
+     */
+    const ColumnStats& getStatistics();
+
+    /**
+     * @brief Choose the encoding of a STRING column
+     *
+     * A dictionary-encoded column stores each distinct string once and a 32-bit
+     * code per row; equality counts and sorting then work on the codes.
+     * Values, indexes and results are the same with both encodings.
+     *
+     * @param enabled true for dictionary encoding, false for plain strings
+     * @return false if the column is not a STRING column
+     */
+    bool setDictionaryEncoding(bool enabled);
+
+    /**
+     * @brief Check whether the column is a dictionary-encoded STRING column
+     */
+    bool isDictionaryEncoded() const;
+
+    /**
+     * @brief Pick the encoding of a STRING column from its cardinality
+     *
+     * Dictionary encoding when there is at most one distinct string per
+     * DICTIONARY_MAX_RATIO rows, plain strings otherwise. No-op on other types.
+     */
+    void optimizeStringEncoding();
+
     /**
      * @brief Test if a value exists in a column
+     *
+     * Same matches as occurence and findRows: a NaN cell is equal to any
+     * comparable probe.
+     *
      * @param val: The value to search for
      * @return: -1: column not sorted,
      *           0: value not found
@@ -159,6 +430,85 @@ public:
      */
     bool exist(const ColumnValue& value);
 
+    /**
+     * @brief Position in the index of the first row not ordered before a value
+     * In an ascending index it is the number of rows lower than value, in a
+     * descending one the number of NULL rows and rows greater than value.
+     * @param value The value to search for
+     * @return The position, or -1 if the index is not valid
+     */
+    int lowerBound(const ColumnValue& value) const;
+
+    /**
+     * @brief Position in the index of the first row ordered after a value
+     * @param value The value to search for
+     * @return The position, or -1 if the index is not valid
+     */
+    int upperBound(const ColumnValue& value) const;
+
+    /**
+     * @brief Count the rows whose value is in [lo, hi) with the index, in O(log n)
+     * @param lo Lower bound (included)
+     * @param hi Upper bound (excluded)
+     * @return The number of rows, or -1 if the index is not valid
+     */
+    int countInRange(const ColumnValue& lo, const ColumnValue& hi) const;
+
+    /**
+     * @brief Row numbers of the rows whose value is in [lo, hi), using the index
+     * @param lo Lower bound (included)
+     * @param hi Upper bound (excluded)
+     * @return The row numbers in increasing order, empty if the index is not valid
+     */
+    std::vector<size_t> rowsInRange(const ColumnValue& lo, const ColumnValue& hi) const;
+
+    /**
+     * @brief Row numbers of the rows equal to a value, using the hash index or the sorted index
+     * @param value The value to search for
+     * @return The row numbers in increasing order, empty if there is neither a hash index nor a valid index
+     */
+    std::vector<size_t> findRows(const ColumnValue& value) const;
+
+
+    /**
+     * @brief Mark the rows of [begin, end) that satisfy a predicate
+     *
+     * Values compare like in occurence and rowsInRange (strings in
+     * lexicographic order, numbers exactly): NULL rows only match
+     * IS_NULL, and a value that cannot be compared to the column type, like a
+     * string against numbers, matches no row. Numeric columns are tested 64
+     * rows at a time by the vectorized kernels; while the statistics are
+     * current, zones whose bounds rule out any match are not read.
+     *
+     * @param op Test to apply
+     * @param value Value compared against (lower bound for RANGE, unused for IS_NULL / NOT_NULL)
+     * @param upper Upper bound (excluded) for RANGE, unused otherwise
+     * @param begin First row to test
+     * @param end One past the last row to test (clamped to the column size)
+     * @param out Receives the matching rows: bit r of out is row 64 * (begin / 64) + r.
+     *            Bits are only set, so successive calls accumulate (OR).
+     */
+    void select(PredicateOp op, const ColumnValue& value, const ColumnValue& upper,
+                size_t begin, size_t end, uint64_t* out) const;
+
+    /**
+     * @brief New column (same name, type and string encoding) holding the selected rows
+     *
+     * Indexes are not copied; the values are gathered in one pass over the selection.
+     *
+     * @param selected Rows to keep (bit set); rows past its end are dropped
+     */
+    Column gather(const ValidityBitmap& selected) const;
+
+    /**
+     * @brief New column (same name, type and string encoding) holding the given rows, in the given order
+     *
+     * Indexes are not copied. Rows may come in any order and repeat, as in
+     * the row pairs of a join.
+     *
+     * @param rows Row to copy for each row of the result; NO_ROW gives a NULL row
+     */
+    Column gather(const std::vector<uint32_t>& rows) const;
 
     /**
      * @brief Access/replace the value located in a cell of the column using its row number
@@ -174,13 +524,54 @@ public:
     * @return: String representation of the value
     */
     std::string valueToString(size_t i) const;
+
+    /**
+    * @brief: Write a column value to a stream, like valueToString but without copying strings
+    * @param out: The stream to write to
+    * @param i: The index of the value to write ("NULL" for a NULL or out-of-range row)
+    */
+    void writeValue(std::ostream& out, size_t i) const;
     
+    /**
+     * @brief Write the column values in the native binary layout (see ColumnStorage::writeBinary)
+     * @param out Output stream (binary mode)
+     */
+    void writeBinary(std::ostream& out) const;
+
+    /**
+     * @brief Replace the column values with rows read from the native binary layout
+     * @param p Read cursor, moved past the column section on success
+     * @param end End of the readable range
+     * @param rows Number of rows stored in the section
+     * @return true if the section was read, false if it is truncated
+     */
+    bool readBinary(const char*& p, const char* end, size_t rows);
+
     /*
     * @brief Insert a value into the column, automatically handling type conversion.
     * @param v The value to insert.
     * @return true if insertion succeeded, false otherwise.
     */
     bool insertValueAuto(const ColumnValue &v);
+
+    /**
+     * @brief Append a batch of values, converted like insertValueAuto
+     *
+     * The batch is converted in one typed loop and capacity is reserved once.
+     * It is all or nothing: if one value cannot be converted, nothing is inserted.
+     *
+     * @param values The values to append, in row order
+     * @return true if every value was inserted, false otherwise (column unchanged)
+     */
+    bool insertValuesAuto(const std::vector<ColumnValue>& values);
+
+    /**
+     * @brief Append one field of every row of a row-major batch, like insertValuesAuto
+     * @param rows The rows, each holding at least field + 1 values
+     * @param field Index of the value to take in each row
+     * @return true if every value was inserted, false otherwise (column unchanged)
+     */
+    bool insertValuesAuto(const std::vector<std::vector<ColumnValue>>& rows, size_t field);
 };
 
 
@@ -0,0 +1,205 @@
+#ifndef COLUMN_COMPARE_H
+#define COLUMN_COMPARE_H
+
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include <limits>
+#include <cstdint>
+
+/**
+ * @brief Text types: a ColumnValue string or a view returned by a StringColumn
+ */
+template <typename T>
+constexpr bool isText = std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+
+/**
+ * @brief Whether values of types A and B can be ordered against each other
+ *
+ * Numbers compare with numbers and text with text; NULL (std::monostate) is
+ * ordered before every value. Any other pair (a string against a number, any
+ * std::any) is not comparable: no value of A is equal to, lower or greater
+ * than a value of B.
+ */
+template <typename A, typename B>
+constexpr bool isComparable = (std::is_arithmetic_v<A> && std::is_arithmetic_v<B>) ||
+                              (isText<A> && isText<B>) ||
+                              std::is_same_v<A, std::monostate> || std::is_same_v<B, std::monostate>;
+
+template <typename A, typename B>
+constexpr int compareNumbers(A a, B b);
+
+/**
+ * Integer against floating point, exactly: the float is split into its
+ * integral part (which fits in int64_t / uint64_t once out-of-range values
+ * are set aside) and the sign of its fractional part.
+ */
+template <typename I, typename F>
+constexpr int compareIntFloat(I i, F f)
+{
+    if (f != f) return 0;
+
+    // 2^64 et -2^63 sont exacts dans tout type flottant
+    if (f >= static_cast<F>(18446744073709551616.0)) return -1;
+    if (f < static_cast<F>(-9223372036854775808.0)) return 1;
+
+    if (f < 0) {
+        const int64_t t = static_cast<int64_t>(f);
+        const int c = compareNumbers(i, t);
+        if (c != 0) return c;
+        return static_cast<F>(t) > f ? 1 : 0;
+    }
+    const uint64_t t = static_cast<uint64_t>(f);
+    const int c = compareNumbers(i, t);
+    if (c != 0) return c;
+    return static_cast<F>(t) < f ? -1 : 0;
+}
+
+/**
+ * @brief Exact three-way comparison of two numbers of any types
+ *
+ * Same types compare natively; signed against unsigned integers never wrap,
+ * integers against floats are compared exactly (no rounding of either side).
+ *
+ * @return -1 if a < b, 1 if a > b, 0 if equal or if one of them is NaN
+ */
+template <typename A, typename B>
+constexpr int compareNumbers(A a, B b)
+{
+    if constexpr (std::is_floating_point_v<A> && std::is_floating_point_v<B>) {
+        // float -> double est exact : la promotion usuelle suffit
+        return (a > b) - (a < b);
+    } else if constexpr (std::is_floating_point_v<B>) {
+        return compareIntFloat(a, b);
+    } else if constexpr (std::is_floating_point_v<A>) {
+        return -compareIntFloat(b, a);
+    } else if constexpr (std::is_signed_v<A> == std::is_signed_v<B>) {
+        return (a > b) - (a < b);
+    } else if constexpr (std::is_signed_v<A>) {
+        if (a < 0) return -1;
+        const uint64_t ua = static_cast<uint64_t>(a);
+        const uint64_t ub = static_cast<uint64_t>(b);
+        return (ua > ub) - (ua < ub);
+    } else {
+        return -compareNumbers(b, a);
+    }
+}
+
+/**
+ * @brief Three-way comparison of two values, resolved at compile time for the pair (A, B)
+ * @return -1 if a < b, 0 if a == b, 1 if a > b; 0 when a NaN is involved
+ *         (a NaN compares equal to anything) or when isComparable<A, B> is false
+ */
+template <typename A, typename B>
+constexpr int compareScalar(const A& va, const B& vb)
+{
+    // NULL handling
+    if constexpr (std::is_same_v<A, std::monostate> && std::is_same_v<B, std::monostate>) return 0;
+    else if constexpr (std::is_same_v<A, std::monostate>) return -1;
+    else if constexpr (std::is_same_v<B, std::monostate>) return 1;
+
+    // string vs string
+    else if constexpr (isText<A> && isText<B>) {
+        const int cmp = std::string_view(va).compare(std::string_view(vb));
+        return (cmp > 0) - (cmp < 0);
+    }
+
+    // numeric vs numeric
+    else if constexpr (std::is_arithmetic_v<A> && std::is_arithmetic_v<B>) return compareNumbers(va, vb);
+
+    // incompatible
+    else return 0;
+}
+
+/**
+ * @class ProbeComparator
+ * @brief Comparison of values of type T against one numeric probe, resolved once
+ *
+ * The probe is replaced by a threshold of type T (the largest integer not
+ * above it for an integer type, the nearest value for a floating type, the
+ * bound of T when it is out of range) and by the comparison of that threshold
+ * with the probe. Every cell is then compared natively to the threshold, with
+ * the same result as compareScalar(cell, probe).
+ */
+template <typename T>
+struct ProbeComparator {
+    T threshold;
+
+    /**
+     * @brief compareScalar(threshold, probe): 0 when the probe is exactly a value of T
+     */
+    int atThreshold;
+
+    /**
+     * @brief NaN probe against an integer type: every value compares equal
+     */
+    bool unordered;
+
+    template <typename P>
+    explicit ProbeComparator(P probe)
+        : threshold(), atThreshold(0), unordered(false)
+    {
+        if constexpr (std::is_same_v<T, P>) {
+            this->threshold = probe;
+        } else {
+            if constexpr (std::is_floating_point_v<P>) {
+                if (probe != probe) {
+                    if constexpr (std::is_floating_point_v<T>) this->threshold = std::numeric_limits<T>::quiet_NaN();
+                    else this->unordered = true;
+                    return;
+                }
+            }
+
+            if constexpr (std::is_integral_v<T>) {
+                if (compareNumbers(probe, std::numeric_limits<T>::min()) < 0) {
+                    this->threshold = std::numeric_limits<T>::min();
+                } else if (compareNumbers(probe, std::numeric_limits<T>::max()) > 0) {
+                    this->threshold = std::numeric_limits<T>::max();
+                } else {
+                    // dans les bornes : troncature, puis partie entière inférieure
+                    this->threshold = static_cast<T>(probe);
+                    if (compareNumbers(this->threshold, probe) > 0) this->threshold--;
+                }
+            } else {
+                if (compareNumbers(probe, std::numeric_limits<T>::max()) > 0) this->threshold = std::numeric_limits<T>::infinity();
+                else if (compareNumbers(probe, std::numeric_limits<T>::lowest()) < 0) this->threshold = -std::numeric_limits<T>::infinity();
+                else this->threshold = static_cast<T>(probe);
+            }
+            this->atThreshold = compareNumbers(this->threshold, probe);
+        }
+    }
+
+    /**
+     * @brief compareScalar(x, probe)
+     */
+    int compare(T x) const
+    {
+        if constexpr (std::is_floating_point_v<T>) {
+            if (x != x) return 0;
+        }
+        if (this->unordered) return 0;
+        if (x < this->threshold) return -1;
+        if (x > this->threshold) return 1;
+        return this->atThreshold;
+    }
+};
+
+/**
+ * @brief Comparator of values of type T against a probe, resolved once per operation
+ *
+ * A ProbeComparator for a numeric pair, compareScalar for the other pairs.
+ * The returned callable takes a cell (a view for strings) and returns
+ * compareScalar(cell, probe).
+ */
+template <typename T, typename P>
+auto probeComparator(const P& probe)
+{
+    if constexpr (std::is_arithmetic_v<T> && std::is_arithmetic_v<P>) {
+        return [c = ProbeComparator<T>(probe)](T x) { return c.compare(x); };
+    } else {
+        return [&probe](const auto& x) { return compareScalar(x, probe); };
+    }
+}
+
+#endif
@@ -0,0 +1,183 @@
+// ========================= ColumnHashIndex.cpp =========================
+#include <algorithm>
+#include <type_traits>
+#include <variant>
+
+#include "ColumnHashIndex.h"
+#include "ColumnSort.h"
+#include "ColumnCompare.h"
+
+template <typename T>
+static uint64_t numericKey(T v)
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        if (v == 0) v = 0;  // -0.0 et +0.0 ont la même clé
+    }
+    return static_cast<uint64_t>(radixKey(v));
+}
+
+/**
+ * Key of the only T value equal to a numeric probe; false when no value of T
+ * is equal to it (non-integer or out of range for an integer column, not
+ * exactly representable for a float column).
+ */
+template <typename T, typename P>
+static bool probeKey(P probe, uint64_t& key)
+{
+    const ProbeComparator<T> resolved(probe);
+    if (resolved.unordered || resolved.atThreshold != 0) return false;
+    key = numericKey(resolved.threshold);
+    return true;
+}
+
+// Lignes valides d'un stockage, dans l'ordre
+static std::vector<size_t> validRows(const ColumnStorage& data)
+{
+    std::vector<size_t> out;
+    out.reserve(data.size() - data.getValidity().nullCount());
+    for (size_t i = 0; i < data.size(); ++i)
+        if (data.isValid(i)) out.push_back(i);
+    return out;
+}
+
+std::vector<size_t>* ColumnHashIndex::listOf(const ColumnStorage& data, size_t row)
+{
+    if (!data.isValid(row)) return nullptr;
+
+    return data.visit([&](const auto& vec) -> std::vector<size_t>* {
+        using V = std::decay_t<decltype(vec)>;
+        if constexpr (std::is_same_v<V, std::monostate>) {
+            return nullptr;
+        } else {
+            using T = typename V::value_type;
+            if constexpr (std::is_same_v<T, std::string>) {
+                return &this->strings[std::string(vec[row])];
+            } else if constexpr (std::is_arithmetic_v<T>) {
+                if (vec[row] != vec[row]) return &this->nans;
+                return &this->numbers[numericKey(vec[row])];
+            } else {
+                return nullptr;
+            }
+        }
+    });
+}
+
+void ColumnHashIndex::build(const ColumnStorage& data)
+{
+    this->numbers.clear();
+    this->strings.clear();
+    this->nans.clear();
+
+    for (size_t i = 0; i < data.size(); ++i) {
+        std::vector<size_t>* list = this->listOf(data, i);
+        if (list) list->push_back(i);
+    }
+}
+
+void ColumnHashIndex::insert(const ColumnStorage& data, size_t row)
+{
+    std::vector<size_t>* list = this->listOf(data, row);
+    if (!list) return;
+
+    // cas courant : une ligne ajoutée en fin de colonne
+    if (list->empty() || list->back() < row) list->push_back(row);
+    else list->insert(std::lower_bound(list->begin(), list->end(), row), row);
+}
+
+void ColumnHashIndex::erase(const ColumnStorage& data, size_t row)
+{
+    std::vector<size_t>* list = this->listOf(data, row);
+    if (!list) return;
+
+    auto it = std::lower_bound(list->begin(), list->end(), row);
+    if (it != list->end() && *it == row) list->erase(it);
+    if (!list->empty() || list == &this->nans) return;
+
+    // plus aucune ligne pour cette valeur : on retire la clé
+    data.visit([&](const auto& vec) {
+        using V = std::decay_t<decltype(vec)>;
+        if constexpr (!std::is_same_v<V, std::monostate>) {
+            using T = typename V::value_type;
+            if constexpr (std::is_same_v<T, std::string>) this->strings.erase(std::string(vec[row]));
+            else if constexpr (std::is_arithmetic_v<T>) this->numbers.erase(numericKey(vec[row]));
+        }
+    });
+}
+
+void ColumnHashIndex::shiftDown(size_t row)
+{
+    auto shift = [row](std::vector<size_t>& list) {
+        for (auto it = std::upper_bound(list.begin(), list.end(), row); it != list.end(); ++it) (*it)--;
+    };
+    for (auto& entry : this->numbers) shift(entry.second);
+    for (auto& entry : this->strings) shift(entry.second);
+    shift(this->nans);
+}
+
+/**
+ * Resolve a probe against the index: `all` when every valid row matches,
+ * otherwise the matching rows are `exact` (may be nullptr) plus the NaN rows
+ * when `withNans`.
+ */
+struct HashMatch {
+    bool all;
+    const std::vector<size_t>* exact;
+    bool withNans;
+};
+
+template <typename Numbers, typename Strings>
+static HashMatch matchProbe(const ColumnStorage& data, const ColumnValue& value,
+                            const Numbers& numbers, const Strings& strings)
+{
+    return data.visit([&](const auto& vec) -> HashMatch {
+        using V = std::decay_t<decltype(vec)>;
+        if constexpr (std::is_same_v<V, std::monostate>) {
+            return {false, nullptr, false};
+        } else {
+            return std::visit([&](const auto& probe) -> HashMatch {
+                using T = typename V::value_type;
+                using P = std::decay_t<decltype(probe)>;
+
+                if constexpr (std::is_same_v<P, std::monostate>) {
+                    // une sonde NULL n'est égale à aucune valeur
+                    return {false, nullptr, false};
+                } else if constexpr (std::is_same_v<T, std::string> && std::is_same_v<P, std::string>) {
+                    auto it = strings.find(probe);
+                    return {false, it == strings.end() ? nullptr : &it->second, false};
+                } else if constexpr (std::is_arithmetic_v<T> && std::is_arithmetic_v<P>) {
+                    if (probe != probe) return {true, nullptr, false};
+
+                    uint64_t key;
+                    if (!probeKey<T>(probe, key)) return {false, nullptr, true};
+                    auto it = numbers.find(key);
+                    return {false, it == numbers.end() ? nullptr : &it->second, true};
+                } else {
+                    // types non comparables : aucune ligne n'est égale
+                    return {false, nullptr, false};
+                }
+            }, value);
+        }
+    });
+}
+
+size_t ColumnHashIndex::count(const ColumnStorage& data, const ColumnValue& value) const
+{
+    const HashMatch m = matchProbe(data, value, this->numbers, this->strings);
+    if (m.all) return data.size() - data.getValidity().nullCount();
+    return (m.exact ? m.exact->size() : 0) + (m.withNans ? this->nans.size() : 0);
+}
+
+std::vector<size_t> ColumnHashIndex::rows(const ColumnStorage& data, const ColumnValue& value) const
+{
+    const HashMatch m = matchProbe(data, value, this->numbers, this->strings);
+    if (m.all) return validRows(data);
+
+    std::vector<size_t> out;
+    if (m.exact) out = *m.exact;
+    if (m.withNans && !this->nans.empty()) {
+        const size_t mid = out.size();
+        out.insert(out.end(), this->nans.begin(), this->nans.end());
+        std::inplace_merge(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(mid), out.end());
+    }
+    return out;
+}
@@ -0,0 +1,73 @@
+#ifndef COLUMN_HASH_INDEX_H
+#define COLUMN_HASH_INDEX_H
+
+#include "ColumnStorage.h"
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class ColumnHashIndex
+ * @brief Hash table from the values of a column to the rows holding them.
+ *
+ * Equality follows the same rules as Column::occurence: a numeric probe
+ * matches the cells of equal numeric value whatever their types, -0.0 matches
+ * +0.0, NaN cells match every probe and a NaN probe matches every valid row,
+ * a probe that cannot be compared to the column type (a string against a
+ * number, any std::any) matches no row, and NULL rows never match.
+ *
+ * Numeric values are keyed by their radixKey, strings by their content; the
+ * rows of each key are kept in increasing order. OBJECT columns have no key
+ * (no probe matches them).
+ */
+class ColumnHashIndex {
+private:
+    std::unordered_map<uint64_t, std::vector<size_t>> numbers;
+    std::unordered_map<std::string, std::vector<size_t>> strings;
+
+    /**
+     * @brief Rows holding NaN (FLOAT / DOUBLE columns), in increasing order
+     */
+    std::vector<size_t> nans;
+
+    /**
+     * @brief Row list of the value stored at a row, nullptr for NULL / OBJECT rows
+     */
+    std::vector<size_t>* listOf(const ColumnStorage& data, size_t row);
+
+public:
+    /**
+     * @brief Index every row of a storage, replacing the current content
+     */
+    void build(const ColumnStorage& data);
+
+    /**
+     * @brief Add a row with its current value (after an append or a replacement)
+     */
+    void insert(const ColumnStorage& data, size_t row);
+
+    /**
+     * @brief Forget a row, given its current value (before a removal or a replacement)
+     */
+    void erase(const ColumnStorage& data, size_t row);
+
+    /**
+     * @brief Renumber the rows after the removal of a row (rows above it shift down by one)
+     */
+    void shiftDown(size_t row);
+
+    /**
+     * @brief Number of rows equal to a value, in O(1)
+     */
+    size_t count(const ColumnStorage& data, const ColumnValue& value) const;
+
+    /**
+     * @brief Rows equal to a value, in increasing order
+     */
+    std::vector<size_t> rows(const ColumnStorage& data, const ColumnValue& value) const;
+};
+
+#endif
@@ -0,0 +1,316 @@
+// ========================= ColumnKernels.cpp =========================
+#include <cstring>
+#include <type_traits>
+#include <limits>
+#include <algorithm>
+
+#include "ColumnKernels.h"
+
+#if defined(__GNUC__)
+#define COLUMN_KERNELS_VECTOR 1
+#define KERNEL_INLINE __attribute__((always_inline)) inline
+#if defined(__x86_64__) || defined(__i386__)
+#define COLUMN_KERNELS_X86 1
+#endif
+#else
+#define KERNEL_INLINE inline
+#endif
+
+/* -------------------- scalar -------------------- */
+
+template <KernelOp OP, typename T>
+KERNEL_INLINE bool matchScalar(T x, T p)
+{
+    if constexpr (OP == KernelOp::EQUAL)         return !(x < p) && !(x > p);
+    if constexpr (OP == KernelOp::GREATER)       return x > p;
+    if constexpr (OP == KernelOp::GREATER_EQUAL) return x >= p;
+    if constexpr (OP == KernelOp::LOWER)         return x < p;
+    if constexpr (OP == KernelOp::LOWER_EQUAL)   return x <= p;
+    if constexpr (OP == KernelOp::UNORDERED)     return x != x;
+    return false;
+}
+
+static KERNEL_INLINE size_t lowestBit(uint64_t m)
+{
+#if defined(__GNUC__)
+    return static_cast<size_t>(__builtin_ctzll(m));
+#else
+    size_t j = 0;
+    while (!(m & 1u)) { m >>= 1; j++; }
+    return j;
+#endif
+}
+
+// Bloc partiellement valide : on ne regarde que les lignes dont le bit est à 1
+template <KernelOp OP, typename T>
+KERNEL_INLINE size_t countSparse(const T* x, uint64_t mask, T p)
+{
+    size_t cnt = 0;
+    for (; mask; mask &= mask - 1)
+        cnt += matchScalar<OP>(x[lowestBit(mask)], p);
+    return cnt;
+}
+
+// Masque des bits [lo, hi) d'un mot, 0 <= lo <= hi <= 64
+static KERNEL_INLINE uint64_t bitRange(size_t lo, size_t hi)
+{
+    const uint64_t upTo = hi >= 64 ? ~uint64_t{0} : ((uint64_t{1} << hi) - 1);
+    return upTo & ~((uint64_t{1} << lo) - 1);
+}
+
+// Lignes [begin, stop) d'un même bloc de 64, traitées une à une
+template <KernelOp OP, typename T>
+KERNEL_INLINE size_t countPartialBlock(const T* values, const uint64_t* validity, size_t begin, size_t stop, T p)
+{
+    const size_t w = begin / 64;
+    const uint64_t mask = validity[w] & bitRange(begin - w * 64, stop - w * 64);
+    return countSparse<OP>(values + w * 64, mask, p);
+}
+
+template <KernelOp OP, typename T>
+static size_t countScalar(const T* values, const uint64_t* validity, size_t begin, size_t end, T p)
+{
+    size_t cnt = 0;
+    for (size_t i = begin; i < end; ) {
+        const size_t stop = std::min(end, (i / 64 + 1) * 64);
+        cnt += countPartialBlock<OP>(values, validity, i, stop, p);
+        i = stop;
+    }
+    return cnt;
+}
+
+/* -------------------- vectorized -------------------- */
+
+#ifdef COLUMN_KERNELS_VECTOR
+
+// Ajoute 1 à chaque voie de acc dont la comparaison est vraie (un masque vaut -1)
+template <KernelOp OP, typename V, typename M>
+KERNEL_INLINE void accumulateMatches(M& acc, const V& x, const V& p)
+{
+    if constexpr (OP == KernelOp::EQUAL)              acc -= ~((x < p) | (x > p));
+    else if constexpr (OP == KernelOp::GREATER)       acc -= x > p;
+    else if constexpr (OP == KernelOp::GREATER_EQUAL) acc -= x >= p;
+    else if constexpr (OP == KernelOp::LOWER)         acc -= x < p;
+    else if constexpr (OP == KernelOp::LOWER_EQUAL)   acc -= x <= p;
+    else                                              acc -= x != x;
+}
+
+// Type d'une voie du masque de comparaison (entier signé de même taille que T)
+template <size_t N> struct MaskLane;
+template <> struct MaskLane<1> { using type = int8_t; };
+template <> struct MaskLane<2> { using type = int16_t; };
+template <> struct MaskLane<4> { using type = int32_t; };
+template <> struct MaskLane<8> { using type = int64_t; };
+
+template <size_t L, typename M>
+KERNEL_INLINE size_t sumLanes(const M& acc)
+{
+    size_t total = 0;
+    for (size_t k = 0; k < L; ++k) total += static_cast<size_t>(acc[k]);
+    return total;
+}
+
+/**
+ * Count on vectors of BYTES bytes. Fully valid blocks of 64 rows are compared
+ * lane by lane; each matching lane adds 1 to a per-lane accumulator, which is
+ * flushed before its narrowest lanes (8 bits for UCHAR/CHAR) could overflow.
+ */
+template <KernelOp OP, typename T, size_t BYTES>
+KERNEL_INLINE size_t countBlocks(const T* values, const uint64_t* validity, size_t begin, size_t end, T p)
+{
+    typedef T V __attribute__((vector_size(BYTES)));
+    using M = decltype(V{} < V{});
+    using Lane = typename MaskLane<sizeof(T)>::type;
+
+    constexpr size_t L = BYTES / sizeof(T);
+    constexpr size_t STEPS = 64 / L;
+    constexpr size_t FLUSH = static_cast<size_t>(std::numeric_limits<Lane>::max()) / STEPS;
+
+    const V pv = V{} + p;
+    M acc = {};
+    size_t pending = 0;
+    size_t cnt = 0;
+
+    size_t i = begin;
+    if (i % 64 != 0) {
+        const size_t stop = std::min(end, (i / 64 + 1) * 64);
+        cnt += countPartialBlock<OP>(values, validity, i, stop, p);
+        i = stop;
+    }
+
+    for (; i + 64 <= end; i += 64) {
+        const size_t w = i / 64;
+        const uint64_t mask = validity[w];
+        const T* x = values + w * 64;
+
+        if (mask == ~uint64_t{0}) {
+            for (size_t k = 0; k < 64; k += L) {
+                V xv;
+                std::memcpy(&xv, x + k, BYTES);
+                accumulateMatches<OP>(acc, xv, pv);
+            }
+            if (++pending == FLUSH) {
+                cnt += sumLanes<L>(acc);
+                acc = M{};
+                pending = 0;
+            }
+        } else if (mask != 0) {
+            cnt += countSparse<OP>(x, mask, p);
+        }
+    }
+    cnt += sumLanes<L>(acc);
+
+    if (i < end)
+        cnt += countPartialBlock<OP>(values, validity, i, end, p);
+    return cnt;
+}
+
+#ifdef COLUMN_KERNELS_X86
+template <KernelOp OP, typename T>
+__attribute__((target("avx2"))) static size_t countAvx2(const T* values, const uint64_t* validity, size_t begin, size_t end, T p)
+{
+    return countBlocks<OP, T, 32>(values, validity, begin, end, p);
+}
+#endif
+
+#endif
+
+/* -------------------- dispatch -------------------- */
+
+template <KernelOp OP, typename T>
+static size_t countOp(const T* values, const uint64_t* validity, size_t begin, size_t end, T p)
+{
+#ifdef COLUMN_KERNELS_X86
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx2) return countAvx2<OP, T>(values, validity, begin, end, p);
+#endif
+#ifdef COLUMN_KERNELS_VECTOR
+    return countBlocks<OP, T, 16>(values, validity, begin, end, p);
+#else
+    return countScalar<OP, T>(values, validity, begin, end, p);
+#endif
+}
+
+template <typename T>
+size_t countMatches(const T* values, const uint64_t* validity, size_t begin, size_t end, KernelOp op, T probe)
+{
+    if (begin >= end) return 0;
+
+    switch (op) {
+        case KernelOp::EQUAL:         return countOp<KernelOp::EQUAL>(values, validity, begin, end, probe);
+        case KernelOp::GREATER:       return countOp<KernelOp::GREATER>(values, validity, begin, end, probe);
+        case KernelOp::GREATER_EQUAL: return countOp<KernelOp::GREATER_EQUAL>(values, validity, begin, end, probe);
+        case KernelOp::LOWER:         return countOp<KernelOp::LOWER>(values, validity, begin, end, probe);
+        case KernelOp::LOWER_EQUAL:   return countOp<KernelOp::LOWER_EQUAL>(values, validity, begin, end, probe);
+        case KernelOp::UNORDERED:     return countOp<KernelOp::UNORDERED>(values, validity, begin, end, probe);
+        default:                      return countScalar<KernelOp::EQUAL>(values, validity, begin, end, probe);
+    }
+}
+
+template size_t countMatches<uint32_t>(const uint32_t*, const uint64_t*, size_t, size_t, KernelOp, uint32_t);
+template size_t countMatches<int32_t>(const int32_t*, const uint64_t*, size_t, size_t, KernelOp, int32_t);
+template size_t countMatches<uint16_t>(const uint16_t*, const uint64_t*, size_t, size_t, KernelOp, uint16_t);
+template size_t countMatches<int16_t>(const int16_t*, const uint64_t*, size_t, size_t, KernelOp, int16_t);
+template size_t countMatches<uint64_t>(const uint64_t*, const uint64_t*, size_t, size_t, KernelOp, uint64_t);
+template size_t countMatches<int64_t>(const int64_t*, const uint64_t*, size_t, size_t, KernelOp, int64_t);
+template size_t countMatches<uint8_t>(const uint8_t*, const uint64_t*, size_t, size_t, KernelOp, uint8_t);
+template size_t countMatches<int8_t>(const int8_t*, const uint64_t*, size_t, size_t, KernelOp, int8_t);
+template size_t countMatches<float>(const float*, const uint64_t*, size_t, size_t, KernelOp, float);
+template size_t countMatches<double>(const double*, const uint64_t*, size_t, size_t, KernelOp, double);
+
+/* -------------------- selection -------------------- */
+
+/**
+ * Match bits of a block of 64 rows. The comparisons are first stored one per
+ * byte (a loop the compiler vectorizes), then each group of 8 bytes, all 0 or
+ * 1, is packed into 8 bits with one multiplication.
+ */
+template <KernelOp OP, typename T>
+KERNEL_INLINE uint64_t matchBlock(const T* x, T p)
+{
+    uint8_t hit[64];
+    for (size_t k = 0; k < 64; ++k) hit[k] = matchScalar<OP>(x[k], p);
+
+    uint64_t bits = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    for (size_t k = 0; k < 64; k += 8) {
+        uint64_t bytes;
+        std::memcpy(&bytes, hit + k, 8);
+        // l'octet j (0 ou 1) arrive sur le bit 56 + j
+        bits |= ((bytes * 0x0102040810204080ULL) >> 56) << k;
+    }
+#else
+    for (size_t k = 0; k < 64; ++k) bits |= static_cast<uint64_t>(hit[k]) << k;
+#endif
+    return bits;
+}
+
+template <KernelOp OP, typename T>
+KERNEL_INLINE void selectBlocks(const T* values, const uint64_t* validity, size_t begin, size_t end, T p, uint64_t* out)
+{
+    const size_t first = begin / 64;
+    for (size_t i = begin; i < end; ) {
+        const size_t w = i / 64;
+        const size_t stop = std::min(end, (w + 1) * 64);
+        const uint64_t mask = validity[w] & bitRange(i - w * 64, stop - w * 64);
+        const T* x = values + w * 64;
+
+        if (stop - w * 64 == 64 && mask != 0) {
+            out[w - first] |= matchBlock<OP>(x, p) & mask;
+        } else {
+            // dernier bloc incomplet : les lignes au-delà de end n'existent pas forcément
+            uint64_t bits = 0;
+            for (uint64_t m = mask; m; m &= m - 1) {
+                const size_t j = lowestBit(m);
+                bits |= static_cast<uint64_t>(matchScalar<OP>(x[j], p)) << j;
+            }
+            out[w - first] |= bits;
+        }
+        i = stop;
+    }
+}
+
+#ifdef COLUMN_KERNELS_X86
+template <KernelOp OP, typename T>
+__attribute__((target("avx2"))) static void selectAvx2(const T* values, const uint64_t* validity, size_t begin, size_t end, T p, uint64_t* out)
+{
+    selectBlocks<OP, T>(values, validity, begin, end, p, out);
+}
+#endif
+
+template <KernelOp OP, typename T>
+static void selectOp(const T* values, const uint64_t* validity, size_t begin, size_t end, T p, uint64_t* out)
+{
+#ifdef COLUMN_KERNELS_X86
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx2) return selectAvx2<OP, T>(values, validity, begin, end, p, out);
+#endif
+    selectBlocks<OP, T>(values, validity, begin, end, p, out);
+}
+
+template <typename T>
+void selectMatches(const T* values, const uint64_t* validity, size_t begin, size_t end, KernelOp op, T probe, uint64_t* out)
+{
+    if (begin >= end) return;
+
+    switch (op) {
+        case KernelOp::EQUAL:         return selectOp<KernelOp::EQUAL>(values, validity, begin, end, probe, out);
+        case KernelOp::GREATER:       return selectOp<KernelOp::GREATER>(values, validity, begin, end, probe, out);
+        case KernelOp::GREATER_EQUAL: return selectOp<KernelOp::GREATER_EQUAL>(values, validity, begin, end, probe, out);
+        case KernelOp::LOWER:         return selectOp<KernelOp::LOWER>(values, validity, begin, end, probe, out);
+        case KernelOp::LOWER_EQUAL:   return selectOp<KernelOp::LOWER_EQUAL>(values, validity, begin, end, probe, out);
+        case KernelOp::UNORDERED:     return selectOp<KernelOp::UNORDERED>(values, validity, begin, end, probe, out);
+        default:                      return;
+    }
+}
+
+template void selectMatches<uint32_t>(const uint32_t*, const uint64_t*, size_t, size_t, KernelOp, uint32_t, uint64_t*);
+template void selectMatches<int32_t>(const int32_t*, const uint64_t*, size_t, size_t, KernelOp, int32_t, uint64_t*);
+template void selectMatches<uint16_t>(const uint16_t*, const uint64_t*, size_t, size_t, KernelOp, uint16_t, uint64_t*);
+template void selectMatches<int16_t>(const int16_t*, const uint64_t*, size_t, size_t, KernelOp, int16_t, uint64_t*);
+template void selectMatches<uint64_t>(const uint64_t*, const uint64_t*, size_t, size_t, KernelOp, uint64_t, uint64_t*);
+template void selectMatches<int64_t>(const int64_t*, const uint64_t*, size_t, size_t, KernelOp, int64_t, uint64_t*);
+template void selectMatches<uint8_t>(const uint8_t*, const uint64_t*, size_t, size_t, KernelOp, uint8_t, uint64_t*);
+template void selectMatches<int8_t>(const int8_t*, const uint64_t*, size_t, size_t, KernelOp, int8_t, uint64_t*);
+template void selectMatches<float>(const float*, const uint64_t*, size_t, size_t, KernelOp, float, uint64_t*);
+template void selectMatches<double>(const double*, const uint64_t*, size_t, size_t, KernelOp, double, uint64_t*);
@@ -0,0 +1,62 @@
+#ifndef COLUMN_KERNELS_H
+#define COLUMN_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @enum KernelOp
+ * @brief Comparison evaluated by the counting kernels, as `value OP probe`.
+ */
+enum class KernelOp {
+    EQUAL,         /**< !(x < p) && !(x > p) (a NaN cell compares equal, like compareScalar) */
+    GREATER,       /**< x > p */
+    GREATER_EQUAL, /**< x >= p */
+    LOWER,         /**< x < p */
+    LOWER_EQUAL,   /**< x <= p */
+    UNORDERED      /**< x != x (NaN cells) */
+};
+
+/**
+ * @brief Count the valid rows in [begin, end) of a typed buffer matching `value OP probe`.
+ *
+ * Rows are processed by blocks of 64 following the validity words (a range that
+ * does not start on a multiple of 64 is first completed row by row): fully NULL
+ * blocks are skipped, fully valid blocks go through a vectorized loop (AVX2 when
+ * the CPU supports it, SSE2/NEON otherwise), mixed blocks are handled row by row.
+ * The implementation is chosen once per call.
+ *
+ * Instantiated for every numeric ColumnValue alternative (uint8_t ... uint64_t,
+ * int8_t ... int64_t, float, double).
+ *
+ * @param values Typed buffer of the whole column
+ * @param validity Validity words of the whole column (bit i of word i/64 is row i)
+ * @param begin First row to count
+ * @param end One past the last row to count
+ * @param op Comparison to evaluate
+ * @param probe Value compared against, already converted to T
+ * @return Number of valid rows matching
+ */
+template <typename T>
+size_t countMatches(const T* values, const uint64_t* validity, size_t begin, size_t end, KernelOp op, T probe);
+
+/**
+ * @brief Set the bits of the valid rows in [begin, end) of a typed buffer matching `value OP probe`.
+ *
+ * Same blocks as countMatches, but every block of 64 rows yields a word of
+ * match bits instead of a count: fully valid blocks are compared in one
+ * branch-free loop, partial ones are masked by their validity word.
+ *
+ * @param values Typed buffer of the whole column
+ * @param validity Validity words of the whole column
+ * @param begin First row to test
+ * @param end One past the last row to test
+ * @param op Comparison to evaluate
+ * @param probe Value compared against, already converted to T
+ * @param out Receives the matches: bit r of out is row 64 * (begin / 64) + r.
+ *            Bits are only set (OR), never cleared.
+ */
+template <typename T>
+void selectMatches(const T* values, const uint64_t* validity, size_t begin, size_t end, KernelOp op, T probe, uint64_t* out);
+
+#endif
@@ -0,0 +1,102 @@
+// ========================= ColumnSort.cpp =========================
+#include <utility>
+
+#include "ColumnSort.h"
+
+// En dessous, un histogramme de 65536 cases coûte plus cher que deux passes de 8 bits
+static const size_t WIDE_DIGIT_MIN_ROWS = 1 << 16;
+
+/**
+ * Stable LSD passes of D bits over (keys, rows); the result ends up in keys/rows.
+ */
+template <unsigned D, typename K>
+static void radixPasses(std::vector<K>& keys, std::vector<size_t>& rows)
+{
+    constexpr size_t BUCKETS = size_t{1} << D;
+    constexpr unsigned PASSES = sizeof(K) * 8 / D;
+    constexpr K MASK = static_cast<K>(BUCKETS - 1);
+
+    const size_t m = keys.size();
+    if (m < 2) return;
+
+    // tous les histogrammes en une seule lecture des clés
+    std::vector<size_t> hist(PASSES * BUCKETS, 0);
+    for (K k : keys) {
+        for (unsigned p = 0; p < PASSES; ++p)
+            hist[p * BUCKETS + ((k >> (p * D)) & MASK)]++;
+    }
+
+    std::vector<K> tmpKeys(m);
+    std::vector<size_t> tmpRows(m);
+
+    for (unsigned p = 0; p < PASSES; ++p) {
+        size_t* h = hist.data() + p * BUCKETS;
+
+        // chiffre identique pour toutes les clés : la passe ne changerait rien
+        const K first = static_cast<K>((keys[0] >> (p * D)) & MASK);
+        if (h[first] == m) continue;
+
+        size_t offset = 0;
+        for (size_t b = 0; b < BUCKETS; ++b) {
+            const size_t c = h[b];
+            h[b] = offset;
+            offset += c;
+        }
+
+        for (size_t i = 0; i < m; ++i) {
+            const size_t dst = h[(keys[i] >> (p * D)) & MASK]++;
+            tmpKeys[dst] = keys[i];
+            tmpRows[dst] = rows[i];
+        }
+        keys.swap(tmpKeys);
+        rows.swap(tmpRows);
+    }
+}
+
+template <typename T>
+void radixArgsort(const T* values, const uint64_t* validity, size_t n, bool ascending, std::vector<size_t>& index)
+{
+    using K = typename RadixKey<sizeof(T)>::type;
+    // décroissant : on trie les clés complémentées, ce qui garde l'ordre des lignes à égalité
+    const K flip = ascending ? K{0} : static_cast<K>(~K{0});
+
+    std::vector<K> keys;
+    std::vector<size_t> rows;
+    std::vector<size_t> nulls;
+    keys.reserve(n);
+    rows.reserve(n);
+
+    for (size_t i = 0; i < n; ++i) {
+        if ((validity[i >> 6] >> (i & 63)) & 1u) {
+            keys.push_back(static_cast<K>(radixKey(values[i]) ^ flip));
+            rows.push_back(i);
+        } else {
+            nulls.push_back(i);
+        }
+    }
+
+    if constexpr (sizeof(K) == 2) {
+        if (keys.size() >= WIDE_DIGIT_MIN_ROWS) radixPasses<16>(keys, rows);
+        else radixPasses<8>(keys, rows);
+    } else {
+        radixPasses<8>(keys, rows);
+    }
+
+    // NULLs en dernier si croissant, en premier si décroissant
+    index.clear();
+    index.reserve(n);
+    if (!ascending) index.insert(index.end(), nulls.begin(), nulls.end());
+    index.insert(index.end(), rows.begin(), rows.end());
+    if (ascending) index.insert(index.end(), nulls.begin(), nulls.end());
+}
+
+template void radixArgsort<uint32_t>(const uint32_t*, const uint64_t*, size_t, bool, std::vector<size_t>&);
+template void radixArgsort<int32_t>(const int32_t*, const uint64_t*, size_t, bool, std::vector<size_t>&);
+template void radixArgsort<uint16_t>(const uint16_t*, const uint64_t*, size_t, bool, std::vector<size_t>&);
+template void radixArgsort<int16_t>(const int16_t*, const uint64_t*, size_t, bool, std::vector<size_t>&);
+template void radixArgsort<uint64_t>(const uint64_t*, const uint64_t*, size_t, bool, std::vector<size_t>&);
+template void radixArgsort<int64_t>(const int64_t*, const uint64_t*, size_t, bool, std::vector<size_t>&);
+template void radixArgsort<uint8_t>(const uint8_t*, const uint64_t*, size_t, bool, std::vector<size_t>&);
+template void radixArgsort<int8_t>(const int8_t*, const uint64_t*, size_t, bool, std::vector<size_t>&);
+template void radixArgsort<float>(const float*, const uint64_t*, size_t, bool, std::vector<size_t>&);
+template void radixArgsort<double>(const double*, const uint64_t*, size_t, bool, std::vector<size_t>&);
@@ -0,0 +1,70 @@
+#ifndef COLUMN_SORT_H
+#define COLUMN_SORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+/**
+ * @brief Unsigned key type of the same width as a numeric type of N bytes.
+ */
+template <size_t N> struct RadixKey;
+template <> struct RadixKey<1> { using type = uint8_t; };
+template <> struct RadixKey<2> { using type = uint16_t; };
+template <> struct RadixKey<4> { using type = uint32_t; };
+template <> struct RadixKey<8> { using type = uint64_t; };
+
+/**
+ * @brief Map a numeric value to a key whose unsigned order is the sort order.
+ *
+ * Signed integers have their sign bit flipped; floats have their IEEE-754 bits
+ * reordered, with -0.0 merged into +0.0 and every NaN mapped after +inf.
+ */
+template <typename T>
+inline typename RadixKey<sizeof(T)>::type radixKey(T v)
+{
+    using K = typename RadixKey<sizeof(T)>::type;
+    constexpr K SIGN = K{1} << (sizeof(K) * 8 - 1);
+
+    if constexpr (std::is_floating_point_v<T>) {
+        if (v != v) v = std::numeric_limits<T>::quiet_NaN();  // un seul NaN, positif
+        if (v == 0) v = 0;                                     // -0.0 == +0.0
+
+        K bits;
+        std::memcpy(&bits, &v, sizeof(K));
+        // négatifs : tous les bits inversés ; positifs : bit de signe mis à 1
+        return (bits & SIGN) ? static_cast<K>(~bits) : static_cast<K>(bits | SIGN);
+    } else if constexpr (std::is_signed_v<T>) {
+        return static_cast<K>(static_cast<K>(v) ^ SIGN);
+    } else {
+        return static_cast<K>(v);
+    }
+}
+
+/**
+ * @brief Argsort a numeric column with an LSD radix sort.
+ *
+ * Every valid value is mapped to its radixKey, then the keys are sorted digit
+ * by digit, least significant first: 1-byte types take a single counting pass,
+ * 2-byte types a single 16-bit pass on large columns, wider types 8-bit passes;
+ * a pass whose digit is the same for every key is skipped.
+ *
+ * The sort is stable, so equal values keep their row order. NULL rows are
+ * placed last when ascending and first when descending, in row order.
+ *
+ * Instantiated for every numeric ColumnValue alternative (uint8_t ... uint64_t,
+ * int8_t ... int64_t, float, double).
+ *
+ * @param values Typed buffer of n values
+ * @param validity Validity words of the column (bit i of word i/64 is row i)
+ * @param n Number of rows
+ * @param ascending true for ascending order, false for descending
+ * @param index Receives the n row numbers in sorted order
+ */
+template <typename T>
+void radixArgsort(const T* values, const uint64_t* validity, size_t n, bool ascending, std::vector<size_t>& index);
+
+#endif
@@ -0,0 +1,420 @@
+// ========================= ColumnStats.cpp =========================
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+#include "ColumnStats.h"
+#include "ColumnCompare.h"
+#include "ColumnSort.h"
+
+// Finaliseur de splitmix64 : chaque bit d'entrée touche tous les bits de sortie
+static uint64_t mixHash(uint64_t h)
+{
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ull;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebull;
+    return h ^ (h >> 31);
+}
+
+template <typename T>
+static uint64_t valueHash(T v)
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        if (v == 0) v = 0;  // -0.0 et +0.0 sont la même valeur
+    }
+    return mixHash(static_cast<uint64_t>(radixKey(v)));
+}
+
+static uint64_t valueHash(std::string_view s)
+{
+    return mixHash(std::hash<std::string_view>{}(s));
+}
+
+/**
+ * compareScalar(bound, probe), or 2 when the two values cannot be compared
+ * (isComparable), in which case no row matches the probe.
+ */
+static int compareBound(const ColumnValue& bound, const ColumnValue& probe)
+{
+    return std::visit([](const auto& a, const auto& b) -> int {
+        if constexpr (!isComparable<std::decay_t<decltype(a)>, std::decay_t<decltype(b)>>) return 2;
+        else return compareScalar(a, b);
+    }, bound, probe);
+}
+
+ColumnStats::ColumnStats()
+    : summarized(0), boundsCurrent(true),
+      sketched(0), sketch(size_t{1} << DISTINCT_SKETCH_BITS, 0), exactOverflow(false), sketchCurrent(true)
+{
+}
+
+void ColumnStats::see(uint64_t hash)
+{
+    const uint64_t rest = hash << DISTINCT_SKETCH_BITS;
+    const uint8_t rank = rest ? static_cast<uint8_t>(__builtin_clzll(rest) + 1)
+                              : static_cast<uint8_t>(64 - DISTINCT_SKETCH_BITS + 1);
+    uint8_t& reg = this->sketch[hash >> (64 - DISTINCT_SKETCH_BITS)];
+    reg = std::max(reg, rank);
+
+    if (this->exactOverflow) return;
+    const auto it = std::lower_bound(this->exact.begin(), this->exact.end(), hash);
+    if (it != this->exact.end() && *it == hash) return;
+    this->exact.insert(it, hash);
+    if (this->exact.size() > DISTINCT_EXACT_MAX) {
+        this->exactOverflow = true;
+        std::vector<uint64_t>().swap(this->exact);
+    }
+}
+
+void ColumnStats::scan(const ColumnStorage& data, size_t begin, size_t end, bool bounds, bool distinct)
+{
+    if (begin >= end) return;
+    const ValidityBitmap& validity = data.getValidity();
+    if (bounds && this->zones.size() < (end + ZONE_ROWS - 1) / ZONE_ROWS)
+        this->zones.resize((end + ZONE_ROWS - 1) / ZONE_ROWS);
+
+    data.visit([&](const auto& vec) {
+        using V = std::decay_t<decltype(vec)>;
+        if constexpr (std::is_same_v<V, std::monostate>) {
+            return;
+        } else {
+            using T = typename V::value_type;
+            // bornes en type natif (vue pour les chaînes), fusionnées ensuite dans la zone et dans la colonne
+            using E = std::conditional_t<std::is_same_v<T, std::string>, std::string_view, T>;
+
+            // une plage par zone traversée
+            for (size_t from = begin; bounds && from < end;) {
+                const size_t to = std::min(end, (from / ZONE_ROWS + 1) * ZONE_ROWS);
+                const size_t valid = validity.countValid(from, to);
+                const bool dense = valid == to - from;
+                Zone& zone = this->zones[from / ZONE_ROWS];
+                zone.nulls += (to - from) - valid;
+                this->whole.nulls += (to - from) - valid;
+
+                E lo{}, hi{};
+                size_t seen = 0;
+                size_t nan = 0;
+                if constexpr (std::is_same_v<T, std::any>) {
+                    seen = valid;
+                } else if constexpr (std::is_arithmetic_v<T>) {
+                    // min / max sans branche, NaN mis à part
+                    if constexpr (std::is_floating_point_v<T>) {
+                        lo = std::numeric_limits<T>::infinity();
+                        hi = -std::numeric_limits<T>::infinity();
+                    } else {
+                        lo = std::numeric_limits<T>::max();
+                        hi = std::numeric_limits<T>::lowest();
+                    }
+                    for (size_t i = from; valid > 0 && i < to; ++i) {
+                        if (!dense && !validity.test(i)) continue;
+                        const T x = vec[i];
+                        if constexpr (std::is_floating_point_v<T>) {
+                            if (x != x) {
+                                nan++;
+                                continue;
+                            }
+                        }
+                        lo = std::min(lo, x);
+                        hi = std::max(hi, x);
+                    }
+                    seen = valid - nan;
+                } else {
+                    for (size_t i = from; valid > 0 && i < to; ++i) {
+                        if (!dense && !validity.test(i)) continue;
+                        const E x = vec[i];
+                        if (!seen++) lo = hi = x;
+                        else if (x < lo) lo = x;
+                        else if (hi < x) hi = x;
+                    }
+                }
+
+                for (Zone* into : {&zone, &this->whole}) {
+                    into->nans += nan;
+                    into->values += seen;
+                    if constexpr (!std::is_same_v<T, std::any>) {
+                        if (!seen) continue;
+                        if (!into->low || lo < std::get<T>(*into->low)) into->low = T(lo);
+                        if (!into->high || std::get<T>(*into->high) < hi) into->high = T(hi);
+                    }
+                }
+                from = to;
+            }
+
+            if constexpr (!std::is_same_v<T, std::any>) {
+                const size_t valid = distinct ? validity.countValid(begin, end) : 0;
+                if (valid == 0) return;
+                const bool dense = valid == end - begin;
+                for (size_t i = begin; i < end; ++i) {
+                    if (!dense && !validity.test(i)) continue;
+                    const E x = vec[i];
+                    if constexpr (std::is_floating_point_v<T>) {
+                        if (x != x) continue;
+                    }
+                    this->see(valueHash(x));
+                }
+            }
+        }
+    });
+}
+
+bool ColumnStats::tally(const ColumnStorage& data, size_t row, Zone& zone, bool add)
+{
+    if (!data.isValid(row)) {
+        if (add) zone.nulls++;
+        else zone.nulls--;
+        return false;
+    }
+
+    return data.visit([&](const auto& vec) -> bool {
+        using V = std::decay_t<decltype(vec)>;
+        if constexpr (std::is_same_v<V, std::monostate>) {
+            return false;
+        } else {
+            using T = typename V::value_type;
+            size_t* count = &zone.values;
+            if constexpr (!std::is_same_v<T, std::any>) {
+                using E = std::conditional_t<std::is_same_v<T, std::string>, std::string_view, T>;
+                const E x = vec[row];
+                bool nan = false;
+                if constexpr (std::is_floating_point_v<T>) nan = x != x;
+                if (nan) {
+                    count = &zone.nans;
+                } else if (add) {
+                    if (!zone.low || x < std::get<T>(*zone.low)) zone.low = T(x);
+                    if (!zone.high || std::get<T>(*zone.high) < x) zone.high = T(x);
+                } else {
+                    zone.values--;
+                    return !(std::get<T>(*zone.low) < x) || !(x < std::get<T>(*zone.high));
+                }
+            }
+            if (add) (*count)++;
+            else (*count)--;
+            return false;
+        }
+    });
+}
+
+void ColumnStats::widen(const ColumnStorage& data, size_t row)
+{
+    if (this->zones.size() <= row / ZONE_ROWS) this->zones.resize(row / ZONE_ROWS + 1);
+    Zone& zone = this->zones[row / ZONE_ROWS];
+    if (!data.isValid(row)) {
+        zone.nulls++;
+        this->whole.nulls++;
+        return;
+    }
+
+    data.visit([&](const auto& vec) {
+        using V = std::decay_t<decltype(vec)>;
+        if constexpr (std::is_same_v<V, std::monostate>) {
+            return;
+        } else {
+            using T = typename V::value_type;
+            if constexpr (std::is_same_v<T, std::any>) {
+                zone.values++;
+                this->whole.values++;
+            } else {
+                using E = std::conditional_t<std::is_same_v<T, std::string>, std::string_view, T>;
+                const E x = vec[row];
+                if constexpr (std::is_floating_point_v<T>) {
+                    if (x != x) {
+                        zone.nans++;
+                        this->whole.nans++;
+                        return;
+                    }
+                }
+                zone.values++;
+                this->whole.values++;
+
+                // dans les bornes de sa zone, donc dans celles de la colonne
+                const T* low = zone.low ? std::get_if<T>(&*zone.low) : nullptr;
+                const T* high = zone.high ? std::get_if<T>(&*zone.high) : nullptr;
+                if (low && high && !(x < *low) && !(*high < x)) return;
+                if (!low || x < *low) zone.low = T(x);
+                if (!high || *high < x) zone.high = T(x);
+                if (!this->whole.low || x < std::get<T>(*this->whole.low)) this->whole.low = T(x);
+                if (!this->whole.high || std::get<T>(*this->whole.high) < x) this->whole.high = T(x);
+            }
+        }
+    });
+}
+
+void ColumnStats::forget(const ColumnStorage& data, size_t row)
+{
+    if (!this->boundsCurrent) return;
+
+    tally(data, row, this->zones[row / ZONE_ROWS], false);
+    // une borne qui s'en va : la suivante n'est connue qu'en relisant la colonne
+    if (tally(data, row, this->whole, false)) this->boundsCurrent = false;
+}
+
+void ColumnStats::remove(const ColumnStorage& data, size_t row)
+{
+    // une esquisse ne sait pas oublier une valeur
+    if (row < this->sketched) {
+        if (data.isValid(row)) this->sketchCurrent = false;
+        this->sketched--;
+    }
+
+    // ligne pas encore résumée : rien à retirer
+    if (row >= this->summarized) return;
+    this->forget(data, row);
+
+    // les lignes suivantes remontent d'un rang : la première de chaque zone passe dans la précédente
+    for (size_t k = row / ZONE_ROWS; this->boundsCurrent && (k + 1) * ZONE_ROWS < this->summarized; ++k) {
+        tally(data, (k + 1) * ZONE_ROWS, this->zones[k + 1], false);
+        tally(data, (k + 1) * ZONE_ROWS, this->zones[k], true);
+    }
+    this->summarized--;
+}
+
+void ColumnStats::replacing(const ColumnStorage& data, size_t row)
+{
+    if (row < this->sketched && data.isValid(row)) this->sketchCurrent = false;
+    if (row < this->summarized) this->forget(data, row);
+}
+
+void ColumnStats::replaced(const ColumnStorage& data, size_t row)
+{
+    this->scan(data, row, row + 1, row < this->summarized && this->boundsCurrent,
+               row < this->sketched && this->sketchCurrent);
+}
+
+void ColumnStats::appended(const ColumnStorage& data, size_t first)
+{
+    // bornes périmées, ou lignes d'avant pas encore résumées : refresh relira tout
+    if (!this->boundsCurrent || first != this->summarized || first >= data.size()) return;
+
+    if (data.size() - first == 1) this->widen(data, first);
+    else this->scan(data, first, data.size(), true, false);
+    this->summarized = data.size();
+}
+
+void ColumnStats::appended(const ColumnStorage& data, size_t first, const ColumnStats& batch)
+{
+    if (!this->boundsCurrent || first != this->summarized || first % ZONE_ROWS != 0
+        || !batch.boundsCurrent || batch.summarized != data.size() - first) {
+        this->appended(data, first);
+        return;
+    }
+
+    // zones du lot alignées sur les nôtres : reprises telles quelles
+    this->zones.resize(first / ZONE_ROWS);
+    this->zones.insert(this->zones.end(), batch.zones.begin(), batch.zones.end());
+    this->zones.resize((data.size() + ZONE_ROWS - 1) / ZONE_ROWS);
+
+    const Zone& from = batch.whole;
+    this->whole.values += from.values;
+    this->whole.nans += from.nans;
+    this->whole.nulls += from.nulls;
+    if (from.low && (!this->whole.low || compareBound(*from.low, *this->whole.low) < 0)) this->whole.low = from.low;
+    if (from.high && (!this->whole.high || compareBound(*this->whole.high, *from.high) < 0)) this->whole.high = from.high;
+    this->summarized = data.size();
+}
+
+void ColumnStats::invalidate()
+{
+    this->summarized = this->sketched = 0;
+    this->boundsCurrent = false;
+    this->sketchCurrent = false;
+}
+
+void ColumnStats::refresh(const ColumnStorage& data, bool distinct)
+{
+    if (!this->boundsCurrent) {
+        this->whole = Zone();
+        this->zones.clear();
+        this->summarized = 0;
+    }
+    if (distinct && !this->sketchCurrent) {
+        std::fill(this->sketch.begin(), this->sketch.end(), 0);
+        this->exact.clear();
+        this->exactOverflow = false;
+        this->sketched = 0;
+    }
+
+    // bornes et esquisse en retard des mêmes lignes : un seul passage
+    const bool fused = distinct && this->sketched == this->summarized;
+    this->scan(data, this->summarized, data.size(), true, fused);
+    if (distinct && !fused) this->scan(data, this->sketched, data.size(), false, true);
+
+    this->summarized = data.size();
+    this->zones.resize((data.size() + ZONE_ROWS - 1) / ZONE_ROWS);
+    this->boundsCurrent = true;
+    if (distinct) {
+        this->sketched = data.size();
+        this->sketchCurrent = true;
+    }
+}
+
+bool ColumnStats::isCurrent(const ColumnStorage& data) const
+{
+    return this->boundsCurrent && this->summarized == data.size();
+}
+
+size_t ColumnStats::distinctCount() const
+{
+    const size_t nan = this->whole.nans > 0 ? 1 : 0;
+    if (this->whole.values == 0) return nan;
+    if (!this->whole.low) return 0;
+    if (!this->exactOverflow) return this->exact.size() + nan;
+
+    // estimation HyperLogLog, comptage linéaire tant que des registres sont vides
+    const double m = static_cast<double>(this->sketch.size());
+    double sum = 0;
+    size_t zeros = 0;
+    for (uint8_t r : this->sketch) {
+        sum += std::ldexp(1.0, -static_cast<int>(r));
+        zeros += r == 0;
+    }
+    double estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+    if (estimate <= 2.5 * m && zeros > 0) estimate = m * std::log(m / static_cast<double>(zeros));
+
+    const size_t count = std::max<size_t>(1, static_cast<size_t>(std::llround(estimate)));
+    return std::min(count, this->whole.values) + nan;
+}
+
+long long ColumnStats::boundedCount(const ColumnStorage& data, const ColumnValue& probe, KernelOp op) const
+{
+    if (!this->isCurrent(data)) return -1;
+    return boundedCount(this->whole, probe, op);
+}
+
+long long ColumnStats::boundedCount(const Zone& zone, const ColumnValue& probe, KernelOp op)
+{
+    if (std::holds_alternative<std::monostate>(probe)) return -1;
+
+    const long long values = static_cast<long long>(zone.values);
+    const long long nans = static_cast<long long>(zone.nans);
+    if (!zone.low) {
+        // que des NULL : rien ne correspond ; des objets ou des NaN seuls : il faut lire les lignes
+        return values == 0 && nans == 0 ? 0 : -1;
+    }
+
+    const int lo = compareBound(*zone.low, probe);
+    const int hi = compareBound(*zone.high, probe);
+    if (lo == 2) return 0;
+
+    // les cellules NaN sont égales à toute sonde, ni plus grandes ni plus petites
+    switch (op) {
+    case KernelOp::EQUAL:
+        if (lo > 0 || hi < 0) return nans;
+        if (lo == 0 && hi == 0) return values + nans;
+        return -1;
+    case KernelOp::GREATER:
+        if (hi <= 0) return 0;
+        if (lo > 0) return values;
+        return -1;
+    case KernelOp::LOWER:
+        if (lo >= 0) return 0;
+        if (hi < 0) return values;
+        return -1;
+    default:
+        return -1;
+    }
+}
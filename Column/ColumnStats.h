@@ -0,0 +1,243 @@
+#ifndef COLUMN_STATS_H
+#define COLUMN_STATS_H
+
+#include "ColumnStorage.h"
+#include "ColumnKernels.h"
+
+#include <vector>
+#include <optional>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief log2 of the number of registers of the distinct-count sketch (1024 registers, ~3% error)
+ */
+const size_t DISTINCT_SKETCH_BITS = 10;
+
+/**
+ * @brief Distinct values counted exactly (by their hashes) before relying on the sketch alone
+ */
+const size_t DISTINCT_EXACT_MAX = 128;
+
+/**
+ * @brief Rows per zone of the zone map (multiple of 64: a zone never splits a validity word)
+ */
+const size_t ZONE_ROWS = size_t{1} << 16;
+
+/**
+ * @class ColumnStats
+ * @brief Summary of the values of a column, kept up to date by its writes.
+ *
+ * Holds the smallest and largest value (numbers by value, strings in
+ * lexicographic order; NULL and NaN cells are left out), the number of
+ * values, NaN cells and NULL cells, and a HyperLogLog sketch estimating the
+ * number of distinct values (exact while there are few of them).
+ *
+ * Every append folds its rows in as it writes them: one row widens the
+ * bounds and counts in O(1), a batch in one typed pass over the new rows.
+ * Removing or replacing a row updates the counts and bounds in place,
+ * unless it held the smallest or the largest value: the bounds are then
+ * stale. Rewrites of the whole storage (removeRows, readBinary) and columns
+ * built in one go (gather) leave everything stale; refresh rebuilds the
+ * stale parts in one pass over the rows.
+ *
+ * The sketch is the one part left to refresh: hashing every value on each
+ * insert would cost as much as the insert, and only the distinct estimate
+ * reads it. refresh(data, true) folds in the rows appended since the last
+ * such refresh. A sketch cannot forget a value, so a removal or a
+ * replacement leaves it to be rebuilt.
+ *
+ * The same bounds and counts are also kept for each zone of ZONE_ROWS
+ * rows (zone map), so that scans skip the zones that cannot hold a match:
+ * on data stored in time order, a range on a timestamp-like column only
+ * reads the few zones it overlaps. A zone only widens between two
+ * rebuilds: a value that leaves it (removed, replaced, or shifted into the
+ * previous zone by a removal) leaves its bounds as they were, which still
+ * holds every remaining value.
+ *
+ * While the summary is current, boundedCount answers the counts of
+ * Column::occurence, numberGreaterThan and numberLowerThan that the bounds
+ * settle (a probe above the largest value, below the smallest one...)
+ * without reading any row, for the whole column or for one zone.
+ */
+class ColumnStats {
+public:
+    /**
+     * @brief Bounds and counts of a set of rows (the whole column or one zone)
+     */
+    struct Zone {
+        std::optional<ColumnValue> low;   /**< Smallest value, NULL and NaN cells left out */
+        std::optional<ColumnValue> high;  /**< Largest value, NULL and NaN cells left out */
+        size_t values = 0;                /**< Rows holding a value other than NaN */
+        size_t nans = 0;                  /**< NaN cells */
+        size_t nulls = 0;                 /**< NULL rows */
+    };
+
+private:
+    /**
+     * @brief Rows [0, summarized) are summarized (all of them unless a write left the bounds stale, or in a gathered column)
+     */
+    size_t summarized;
+
+    Zone whole;
+    std::vector<Zone> zones;  /**< zones[k] covers the rows [k * ZONE_ROWS, (k + 1) * ZONE_ROWS) */
+    bool boundsCurrent;
+
+    /**
+     * @brief Rows [0, sketched) are in the sketch (refresh only folds the next ones in when asked for it)
+     */
+    size_t sketched;
+
+    /**
+     * @brief HyperLogLog registers: highest rank seen among the hashes routed to each
+     */
+    std::vector<uint8_t> sketch;
+
+    /**
+     * @brief Sorted hashes of the distinct values, while there are at most DISTINCT_EXACT_MAX
+     */
+    std::vector<uint64_t> exact;
+    bool exactOverflow;
+    bool sketchCurrent;
+
+    /**
+     * @brief Add the rows [begin, end) to the bounds and counts and / or to the sketch
+     */
+    void scan(const ColumnStorage& data, size_t begin, size_t end, bool bounds, bool distinct);
+
+    /**
+     * @brief Feed one value hash to the sketch and to the exact set
+     */
+    void see(uint64_t hash);
+
+    /**
+     * @brief Take the value of a summarized row out of the counts of its zone and of the column (bounds marked stale when needed)
+     */
+    void forget(const ColumnStorage& data, size_t row);
+
+    /**
+     * @brief Add (or take out) the value of one row to the counts of a zone, widening its bounds when adding
+     * @return true if the value lies on one of the bounds of the zone
+     */
+    static bool tally(const ColumnStorage& data, size_t row, Zone& zone, bool add);
+
+    /**
+     * @brief Add the value of one row to its zone, and to the column only when it widens the zone
+     *
+     * The bounds of a zone always lie within those of the column while they
+     * are current: a value inside its zone's bounds leaves the column's as they are.
+     */
+    void widen(const ColumnStorage& data, size_t row);
+
+public:
+    /**
+     * @brief Statistics of an empty column
+     */
+    ColumnStats();
+
+    /**
+     * @brief Forget a row, given its current value (before its removal; the next rows shift between zones)
+     */
+    void remove(const ColumnStorage& data, size_t row);
+
+    /**
+     * @brief Forget the value of a row about to be replaced
+     */
+    void replacing(const ColumnStorage& data, size_t row);
+
+    /**
+     * @brief Take the new value of a replaced row into account
+     */
+    void replaced(const ColumnStorage& data, size_t row);
+
+    /**
+     * @brief Fold in the rows [first, size) just appended (bounds, counts and zones; not the sketch)
+     */
+    void appended(const ColumnStorage& data, size_t first);
+
+    /**
+     * @brief Same, for rows moved in from a column whose statistics are `batch`
+     *
+     * A batch summarized as a whole and laid at the start of a zone brings
+     * its zones and counts along: nothing is read again.
+     */
+    void appended(const ColumnStorage& data, size_t first, const ColumnStats& batch);
+
+    /**
+     * @brief Mark everything stale (the storage was rewritten as a whole)
+     */
+    void invalidate();
+
+    /**
+     * @brief Rebuild the stale parts (and fold in rows not summarized yet)
+     * @param distinct Also bring the distinct sketch up to date (scans only need the bounds and zones)
+     */
+    void refresh(const ColumnStorage& data, bool distinct = true);
+
+    /**
+     * @brief true if bounds and counts cover every row of the storage (the sketch may still be stale)
+     */
+    bool isCurrent(const ColumnStorage& data) const;
+
+    /**
+     * @brief Smallest value (std::nullopt if the column holds no value, or for OBJECT columns)
+     */
+    const std::optional<ColumnValue>& minimum() const { return this->whole.low; }
+
+    /**
+     * @brief Largest value (std::nullopt if the column holds no value, or for OBJECT columns)
+     */
+    const std::optional<ColumnValue>& maximum() const { return this->whole.high; }
+
+    /**
+     * @brief Number of rows holding a value other than NaN
+     */
+    size_t valueCount() const { return this->whole.values; }
+
+    /**
+     * @brief Number of NaN cells (FLOAT / DOUBLE columns)
+     */
+    size_t nanCount() const { return this->whole.nans; }
+
+    /**
+     * @brief Number of NULL rows
+     */
+    size_t nullCount() const { return this->whole.nulls; }
+
+    /**
+     * @brief Estimated number of distinct values (all NaNs count as one value; 0 for OBJECT columns)
+     *
+     * Exact up to DISTINCT_EXACT_MAX values, within a few percent beyond,
+     * and never more than the number of values. Covers the rows of the last
+     * refresh that included the sketch.
+     */
+    size_t distinctCount() const;
+
+    /**
+     * @brief Number of rows matching `row OP probe` when the bounds settle it
+     *
+     * Same comparisons as Column::occurence (KernelOp::EQUAL),
+     * numberGreaterThan (GREATER) and numberLowerThan (LOWER).
+     *
+     * @return The count over the whole column, or -1 if the rows must be
+     *         scanned (summary not current, probe between the bounds, NULL
+     *         probe). A result of 0 also holds for any range of rows.
+     */
+    long long boundedCount(const ColumnStorage& data, const ColumnValue& probe, KernelOp op) const;
+
+    /**
+     * @brief Bounds and counts of the zone `k` (rows [k * ZONE_ROWS, (k + 1) * ZONE_ROWS))
+     *
+     * Only meaningful while isCurrent: the bounds may be wider than the
+     * values of the zone, the counts are exact.
+     */
+    const Zone& getZone(size_t k) const { return this->zones[k]; }
+
+    /**
+     * @brief Same as boundedCount, on the rows of one zone
+     * @return The count over the zone, or -1 if its rows must be scanned
+     */
+    static long long boundedCount(const Zone& zone, const ColumnValue& probe, KernelOp op);
+};
+
+#endif
@@ -0,0 +1,340 @@
+// ========================= ColumnStorage.cpp =========================
+#include <variant>
+#include <type_traits>
+#include <utility>
+#include <iterator>
+#include <cstring>
+#include <algorithm>
+
+#include "ColumnStorage.h"
+
+/* -------------------- ColumnStorage -------------------- */
+
+static ColumnStorage::Buffer makeBuffer(ColumnType type)
+{
+    switch (type) {
+        case ColumnType::UINT:   return std::vector<uint32_t>();
+        case ColumnType::INT:    return std::vector<int32_t>();
+        case ColumnType::USHORT: return std::vector<uint16_t>();
+        case ColumnType::SHORT:  return std::vector<int16_t>();
+        case ColumnType::ULONG:  return std::vector<uint64_t>();
+        case ColumnType::LONG:   return std::vector<int64_t>();
+        case ColumnType::UCHAR:  return std::vector<uint8_t>();
+        case ColumnType::CHAR:   return std::vector<int8_t>();
+        case ColumnType::FLOAT:  return std::vector<float>();
+        case ColumnType::DOUBLE: return std::vector<double>();
+        case ColumnType::STRING: return StringColumn();
+        case ColumnType::OBJECT: return std::vector<std::any>();
+        case ColumnType::NULLVAL:
+        default:
+            return std::monostate{};
+    }
+}
+
+static bool isNullValue(const std::optional<ColumnValue>& value)
+{
+    return !value.has_value() || std::holds_alternative<std::monostate>(value.value());
+}
+
+ColumnStorage::ColumnStorage(ColumnType type)
+{
+    this->buffer = makeBuffer(type);
+    this->validity = ValidityBitmap();
+}
+
+void ColumnStorage::reserve(size_t n)
+{
+    this->validity.reserve(n);
+    std::visit([n](auto& vec) {
+        using V = std::decay_t<decltype(vec)>;
+        if constexpr (!std::is_same_v<V, std::monostate>)
+            vec.reserve(n);
+    }, this->buffer);
+}
+
+void ColumnStorage::append(std::optional<ColumnValue> value)
+{
+    if (isNullValue(value)) value.reset();
+    this->typed([&value](auto col) { col.insert(std::move(value)); });
+}
+
+bool ColumnStorage::appendString(std::string_view s)
+{
+    StringColumn* strings = std::get_if<StringColumn>(&this->buffer);
+    if (!strings) return false;
+
+    strings->push_back(s);
+    this->validity.push_back(true);
+    return true;
+}
+
+std::string_view ColumnStorage::getString(size_t i) const
+{
+    const StringColumn* strings = std::get_if<StringColumn>(&this->buffer);
+    return strings ? (*strings)[i] : std::string_view();
+}
+
+void ColumnStorage::set(size_t i, std::optional<ColumnValue> value)
+{
+    const bool valid = !isNullValue(value);
+
+    std::visit([&](auto& vec) {
+        using V = std::decay_t<decltype(vec)>;
+        if constexpr (std::is_same_v<V, StringColumn>) {
+            vec.set(i, valid ? std::string_view(std::get<std::string>(value.value())) : std::string_view());
+        } else if constexpr (!std::is_same_v<V, std::monostate>) {
+            using T = typename V::value_type;
+            vec[i] = valid ? std::get<T>(std::move(value.value())) : T();
+        }
+    }, this->buffer);
+
+    this->validity.set(i, valid);
+}
+
+void ColumnStorage::erase(size_t i)
+{
+    std::visit([i](auto& vec) {
+        using V = std::decay_t<decltype(vec)>;
+        if constexpr (std::is_same_v<V, StringColumn>)
+            vec.erase(i);
+        else if constexpr (!std::is_same_v<V, std::monostate>)
+            vec.erase(vec.begin() + static_cast<std::ptrdiff_t>(i));
+    }, this->buffer);
+
+    this->validity.erase(i);
+}
+
+void ColumnStorage::truncate(size_t n)
+{
+    std::visit([n](auto& vec) {
+        using V = std::decay_t<decltype(vec)>;
+        if constexpr (std::is_same_v<V, StringColumn>)
+            vec.removeIf([n](size_t i) { return i >= n; });
+        else if constexpr (!std::is_same_v<V, std::monostate>)
+            vec.erase(vec.begin() + static_cast<std::ptrdiff_t>(std::min(n, vec.size())), vec.end());
+    }, this->buffer);
+}
+
+void ColumnStorage::removeRows(const ValidityBitmap& removed)
+{
+    auto gone = [&removed](size_t i) { return i < removed.size() && removed.test(i); };
+
+    std::visit([&](auto& vec) {
+        using V = std::decay_t<decltype(vec)>;
+        if constexpr (std::is_same_v<V, StringColumn>) {
+            vec.removeIf(gone);
+        } else if constexpr (!std::is_same_v<V, std::monostate>) {
+            size_t kept = 0;
+            for (size_t i = 0; i < vec.size(); ++i) {
+                if (gone(i)) continue;
+                if (kept != i) vec[kept] = std::move(vec[i]);
+                kept++;
+            }
+            vec.erase(vec.begin() + static_cast<std::ptrdiff_t>(kept), vec.end());
+        }
+    }, this->buffer);
+
+    this->validity.removeRows(removed);
+}
+
+void ColumnStorage::extend(const ColumnStorage& other)
+{
+    std::visit([](auto& dst, const auto& src) {
+        using D = std::decay_t<decltype(dst)>;
+        using S = std::decay_t<decltype(src)>;
+        if constexpr (std::is_same_v<D, StringColumn> && std::is_same_v<S, StringColumn>)
+            dst.append(src);
+        else if constexpr (std::is_same_v<D, S> && !std::is_same_v<D, std::monostate>)
+            dst.insert(dst.end(), src.begin(), src.end());
+    }, this->buffer, other.buffer);
+
+    this->validity.append(other.validity);
+}
+
+void ColumnStorage::extend(ColumnStorage&& other)
+{
+    if (this->empty() && this->buffer.index() == other.buffer.index()) {
+        this->buffer = std::move(other.buffer);
+        this->validity = std::move(other.validity);
+    } else {
+        std::visit([](auto& dst, auto& src) {
+            using D = std::decay_t<decltype(dst)>;
+            using S = std::decay_t<decltype(src)>;
+            if constexpr (std::is_same_v<D, StringColumn> && std::is_same_v<S, StringColumn>)
+                dst.append(src);
+            else if constexpr (std::is_same_v<D, S> && !std::is_same_v<D, std::monostate>)
+                dst.insert(dst.end(), std::make_move_iterator(src.begin()), std::make_move_iterator(src.end()));
+        }, this->buffer, other.buffer);
+
+        this->validity.append(other.validity);
+    }
+
+    std::visit([](auto& vec) {
+        using V = std::decay_t<decltype(vec)>;
+        if constexpr (!std::is_same_v<V, std::monostate>)
+            vec.clear();
+    }, other.buffer);
+    other.validity = ValidityBitmap();
+}
+
+void ColumnStorage::appendSelected(const ColumnStorage& other, const ValidityBitmap& selected)
+{
+    const size_t n = std::min(selected.size(), other.size());
+    const size_t count = selected.countValid(0, n);
+    this->reserve(this->size() + count);
+
+    std::visit([&](auto& dst, const auto& src) {
+        using D = std::decay_t<decltype(dst)>;
+        using S = std::decay_t<decltype(src)>;
+        if constexpr (std::is_same_v<D, S> && !std::is_same_v<D, std::monostate>)
+            selected.forEachSet(n, [&](size_t i) { dst.push_back(src[i]); });
+    }, this->buffer, other.buffer);
+
+    ValidityBitmap rows;
+    rows.reserve(count);
+    selected.forEachSet(n, [&](size_t i) { rows.push_back(other.isValid(i)); });
+    this->validity.append(rows);
+}
+
+void ColumnStorage::appendRows(const ColumnStorage& other, const std::vector<uint32_t>& rows)
+{
+    const size_t n = other.size();
+    this->reserve(this->size() + rows.size());
+
+    std::visit([&](auto& dst, const auto& src) {
+        using D = std::decay_t<decltype(dst)>;
+        using S = std::decay_t<decltype(src)>;
+        if constexpr (std::is_same_v<D, StringColumn> && std::is_same_v<S, StringColumn>) {
+            dst.appendRows(src, rows);
+        } else if constexpr (std::is_same_v<D, S> && !std::is_same_v<D, std::monostate>) {
+            for (uint32_t r : rows) {
+                if (r < n) dst.push_back(src[r]);
+                else dst.emplace_back();
+            }
+        }
+    }, this->buffer, other.buffer);
+
+    ValidityBitmap valid;
+    valid.reserve(rows.size());
+    for (uint32_t r : rows) valid.push_back(r < n && other.isValid(r));
+    this->validity.append(valid);
+}
+
+std::optional<ColumnValue> ColumnStorage::get(size_t i) const
+{
+    return this->typed([i](auto col) { return col.get(i); });
+}
+
+/* -------------------- binary layout -------------------- */
+
+static size_t padTo8(size_t n)
+{
+    return (n + 7) & ~size_t{7};
+}
+
+// Complète avec des zéros une section de n octets déjà écrite
+static void writePadding(std::ostream& out, size_t n)
+{
+    static const char zeros[8] = {0};
+    out.write(zeros, static_cast<std::streamsize>(padTo8(n) - n));
+}
+
+static void writePadded(std::ostream& out, const void* src, size_t n)
+{
+    if (n > 0) out.write(static_cast<const char*>(src), static_cast<std::streamsize>(n));
+    writePadding(out, n);
+}
+
+// Réserve n octets (alignés sur 8) dans [p, end) ; nullptr si la plage est trop courte
+static const char* takePadded(const char*& p, const char* end, size_t n)
+{
+    const size_t padded = padTo8(n);
+    if (padded < n || static_cast<size_t>(end - p) < padded) return nullptr;
+    const char* src = p;
+    p += padded;
+    return src;
+}
+
+void ColumnStorage::writeBinary(std::ostream& out) const
+{
+    const size_t rows = this->size();
+    const bool isObject = std::holds_alternative<std::vector<std::any>>(this->buffer);
+
+    if (isObject) {
+        const std::vector<uint64_t> none((rows + 63) / 64, 0);
+        writePadded(out, none.data(), none.size() * sizeof(uint64_t));
+    } else {
+        const auto& words = this->validity.raw();
+        writePadded(out, words.data(), words.size() * sizeof(uint64_t));
+    }
+
+    std::visit([&out, rows](const auto& vec) {
+        using V = std::decay_t<decltype(vec)>;
+        if constexpr (std::is_same_v<V, StringColumn>) {
+            std::vector<uint64_t> offsets;
+            offsets.reserve(rows + 1);
+            offsets.push_back(0);
+            for (size_t i = 0; i < rows; ++i) offsets.push_back(offsets.back() + vec[i].size());
+            writePadded(out, offsets.data(), offsets.size() * sizeof(uint64_t));
+
+            for (size_t i = 0; i < rows; ++i) out.write(vec[i].data(), static_cast<std::streamsize>(vec[i].size()));
+            writePadding(out, static_cast<size_t>(offsets.back()));
+        } else if constexpr (!std::is_same_v<V, std::monostate> && !std::is_same_v<V, std::vector<std::any>>) {
+            writePadded(out, vec.data(), rows * sizeof(typename V::value_type));
+        }
+    }, this->buffer);
+}
+
+bool ColumnStorage::readBinary(const char*& p, const char* end, size_t rows)
+{
+    const char* cursor = p;
+
+    const size_t nwords = (rows + 63) / 64;
+    const char* words = takePadded(cursor, end, nwords * sizeof(uint64_t));
+    if (!words) return false;
+
+    const bool ok = std::visit([&](auto& vec) -> bool {
+        using V = std::decay_t<decltype(vec)>;
+        if constexpr (std::is_same_v<V, std::monostate>) {
+            return true;
+        } else if constexpr (std::is_same_v<V, std::vector<std::any>>) {
+            vec.assign(rows, std::any());
+            return true;
+        } else if constexpr (std::is_same_v<V, StringColumn>) {
+            const char* rawOffsets = takePadded(cursor, end, (rows + 1) * sizeof(uint64_t));
+            if (!rawOffsets) return false;
+
+            std::vector<uint64_t> offsets(rows + 1);
+            std::memcpy(offsets.data(), rawOffsets, offsets.size() * sizeof(uint64_t));
+
+            const char* bytes = takePadded(cursor, end, static_cast<size_t>(offsets.back()));
+            if (!bytes) return false;
+
+            vec.clear();
+            vec.reserve(rows);
+            vec.reserveBytes(static_cast<size_t>(offsets.back()));
+            for (size_t i = 0; i < rows; ++i) {
+                if (offsets[i] > offsets[i + 1] || offsets[i + 1] > offsets.back()) return false;
+                vec.push_back(std::string_view(bytes + offsets[i], static_cast<size_t>(offsets[i + 1] - offsets[i])));
+            }
+            return true;
+        } else {
+            using T = typename V::value_type;
+            const char* values = takePadded(cursor, end, rows * sizeof(T));
+            if (!values) return false;
+
+            vec.resize(rows);
+            if (rows > 0) std::memcpy(vec.data(), values, rows * sizeof(T));
+            return true;
+        }
+    }, this->buffer);
+
+    if (!ok) return false;
+
+    std::vector<uint64_t> aligned(nwords);
+    if (nwords > 0) std::memcpy(aligned.data(), words, nwords * sizeof(uint64_t));
+    this->validity.assign(aligned.data(), rows);
+
+    p = cursor;
+    return true;
+}
@@ -0,0 +1,252 @@
+#ifndef COLUMN_STORAGE_H
+#define COLUMN_STORAGE_H
+
+#include "ColumnValue.h"
+#include "StringColumn.h"
+#include "ValidityBitmap.h"
+#include "TypedColumn.h"
+
+#include <vector>
+#include <optional>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * @class ColumnStorage
+ * @brief Typed contiguous storage engine behind a Column.
+ *
+ * Each ColumnType is kept in a tightly packed `std::vector<T>` (an `int32_t`
+ * array for INT, an `uint8_t` array for UCHAR, ...). NULLs are tracked in a
+ * separate ValidityBitmap; a NULL row keeps a default-constructed placeholder
+ * in the typed buffer so that row `i` is always at position `i`.
+ *
+ * The buffer alternatives follow the same order as ColumnValue, so that the
+ * element type of a buffer is always one of the ColumnValue alternatives.
+ * A NULLVAL column has no buffer at all (std::monostate), only the bitmap.
+ */
+class ColumnStorage {
+public:
+    using Buffer = std::variant<
+        std::monostate, // NULLVAL: only the validity bitmap
+        std::vector<uint32_t>,
+        std::vector<int32_t>,
+        std::vector<uint16_t>,
+        std::vector<int16_t>,
+        std::vector<uint64_t>,
+        std::vector<int64_t>,
+        std::vector<uint8_t>,
+        std::vector<int8_t>,
+        std::vector<float>,
+        std::vector<double>,
+        StringColumn,   // plain or dictionary-encoded strings
+        std::vector<std::any>
+    >;
+
+private:
+    Buffer buffer;
+    ValidityBitmap validity;
+
+    /**
+     * @brief Drop the typed values past the first n (the validity bitmap is not touched)
+     */
+    void truncate(size_t n);
+
+public:
+    /**
+     * @brief Create an empty storage for a given column type
+     * @param type Logical type of the column
+     */
+    explicit ColumnStorage(ColumnType type);
+
+    /**
+     * @brief Logical type of the stored values
+     */
+    ColumnType type() const { return static_cast<ColumnType>(this->buffer.index() + 1); }
+
+    /**
+     * @brief Number of rows stored
+     */
+    size_t size() const { return this->validity.size(); }
+
+    /**
+     * @brief true if no row is stored
+     */
+    bool empty() const { return this->validity.size() == 0; }
+
+    /**
+     * @brief Test whether a row holds a value
+     */
+    bool isValid(size_t i) const { return this->validity.test(i); }
+
+    /**
+     * @brief Access the validity bitmap
+     */
+    const ValidityBitmap& getValidity() const { return this->validity; }
+
+    /**
+     * @brief Reserve room for n rows
+     */
+    void reserve(size_t n);
+
+    /**
+     * @brief Append a row
+     * @param value The value to append; std::nullopt or std::monostate append a NULL.
+     *              The alternative must match the buffer type (checked by Column).
+     */
+    void append(std::optional<ColumnValue> value);
+
+    /**
+     * @brief Append a valid row to a STRING buffer, copying the bytes straight into its arena
+     * @return false (nothing appended) if the buffer does not hold strings
+     */
+    bool appendString(std::string_view s);
+
+    /**
+     * @brief View on the string of a row of a STRING buffer
+     * @param i Row index (must be < size())
+     * @return The string (valid until the storage is modified), an empty view for other buffers
+     */
+    std::string_view getString(size_t i) const;
+
+    /**
+     * @brief Replace the value of an existing row
+     * @param i Row index (must be < size())
+     * @param value New value, same rules as append()
+     */
+    void set(size_t i, std::optional<ColumnValue> value);
+
+    /**
+     * @brief Remove a row
+     * @param i Row index (must be < size())
+     */
+    void erase(size_t i);
+
+    /**
+     * @brief Remove every row set in `removed` in one linear pass
+     * @param removed Rows to remove (bit set); rows past its end are kept
+     */
+    void removeRows(const ValidityBitmap& removed);
+
+    /**
+     * @brief Append all rows of another storage of the same type
+     * @param other Storage to copy from (must hold the same buffer type)
+     */
+    void extend(const ColumnStorage& other);
+
+    /**
+     * @brief Append all rows of another storage of the same type, moving its values
+     * @param other Storage to move from (must hold the same buffer type); left empty
+     */
+    void extend(ColumnStorage&& other);
+
+    /**
+     * @brief Append the rows of another storage of the same type whose bit is set in `selected`
+     * @param other Storage to copy from (must hold the same buffer type)
+     * @param selected Rows to copy (bit set), in increasing order; rows past its end are not copied
+     */
+    void appendSelected(const ColumnStorage& other, const ValidityBitmap& selected);
+
+    /**
+     * @brief Append rows of another storage of the same type, picked by row number
+     * @param other Storage to copy from (must hold the same buffer type)
+     * @param rows Row of `other` to copy for each appended row, in any order and possibly
+     *             repeated; a row past the end of `other` (e.g. NO_ROW) appends a NULL
+     */
+    void appendRows(const ColumnStorage& other, const std::vector<uint32_t>& rows);
+
+    /**
+     * @brief Write the rows in the native binary layout
+     *
+     * Layout (native byte order, every section padded to 8 bytes):
+     * - validity words, `(rows + 63) / 64` x uint64_t
+     * - fixed-width types: `rows` x sizeof(T)
+     * - STRING: `rows + 1` x uint64_t offsets, then the concatenated bytes
+     * - OBJECT: nothing (std::any cannot be serialized, rows are written as NULL)
+     * - NULLVAL: nothing
+     *
+     * The number of rows is not part of the section, the caller stores it.
+     *
+     * @param out Output stream (binary mode)
+     */
+    void writeBinary(std::ostream& out) const;
+
+    /**
+     * @brief Replace the content with rows read from the native binary layout
+     * @param p Read cursor, moved past the column section on success
+     * @param end End of the readable range
+     * @param rows Number of rows, read by the caller from the file header
+     * @return false if the range is too short for the announced rows
+     */
+    bool readBinary(const char*& p, const char* end, size_t rows);
+
+    /**
+     * @brief Materialize a row as a ColumnValue
+     * @param i Row index (must be < size())
+     * @return The value, or std::nullopt if the row is NULL
+     */
+    std::optional<ColumnValue> get(size_t i) const;
+
+    /**
+     * @brief Dispatch once on the buffer type
+     *
+     * The visitor receives either `std::monostate` (NULLVAL column) or the
+     * `std::vector<T>` holding the column values.
+     */
+    template <typename F>
+    decltype(auto) visit(F&& f) const { return std::visit(std::forward<F>(f), this->buffer); }
+
+    template <typename F>
+    decltype(auto) visit(F&& f) { return std::visit(std::forward<F>(f), this->buffer); }
+
+    /**
+     * @brief Dispatch once on the element type, with the validity bitmap
+     *
+     * The visitor receives a TypedColumn<T> on the buffer and the bitmap (a
+     * TypedColumn<const T> on a const storage), T being the element type.
+     */
+    template <typename F>
+    decltype(auto) typed(F&& f)
+    {
+        return std::visit([&](auto& vec) -> decltype(auto) {
+            using T = typename BufferElement<std::decay_t<decltype(vec)>>::type;
+            return f(TypedColumn<T>(vec, this->validity));
+        }, this->buffer);
+    }
+
+    template <typename F>
+    decltype(auto) typed(F&& f) const
+    {
+        return std::visit([&](const auto& vec) -> decltype(auto) {
+            using T = typename BufferElement<std::decay_t<decltype(vec)>>::type;
+            return f(TypedColumn<const T>(vec, this->validity));
+        }, this->buffer);
+    }
+
+    /**
+     * @brief Append a batch of rows in one pass over the typed buffer
+     *
+     * `fill(buffer, rows)` receives the typed buffer (as with visit) and an
+     * empty ValidityBitmap, and appends the same number of rows to both. If it
+     * returns false, the rows it appended are dropped and the storage is left
+     * as it was.
+     *
+     * @return The value returned by fill
+     */
+    template <typename F>
+    bool appendBatch(F&& fill)
+    {
+        const size_t before = this->size();
+        ValidityBitmap rows;
+        const bool ok = std::visit([&](auto& vec) -> bool { return fill(vec, rows); }, this->buffer);
+        if (!ok) {
+            this->truncate(before);
+            return false;
+        }
+        this->validity.append(rows);
+        return true;
+    }
+};
+
+#endif
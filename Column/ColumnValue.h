@@ -1,4 +1,9 @@
+#pragma once
+
 #include <any>
+#include <cstdint>
+#include <string>
+#include <variant>
 
 /**
  * @enum ColumnType
@@ -0,0 +1,318 @@
+// ========================= StringColumn.cpp =========================
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <unordered_set>
+#include <utility>
+#include <limits>
+
+#include "StringColumn.h"
+
+/* -------------------- StringArena -------------------- */
+
+// premier bloc d'une arène : les petites colonnes ne réservent pas STRING_ARENA_BLOCK octets
+static const size_t STRING_ARENA_FIRST_BLOCK = 256;
+
+StringArena::StringArena()
+{
+    this->used = 0;
+    this->capacity = 0;
+    this->total = 0;
+    this->reserved = 0;
+}
+
+StringArena::StringArena(StringArena&& other)
+    : blocks(std::move(other.blocks)),
+      used(other.used),
+      capacity(other.capacity),
+      total(other.total),
+      reserved(other.reserved)
+{
+    other.blocks.clear();
+    other.used = other.capacity = other.total = other.reserved = 0;
+}
+
+StringArena& StringArena::operator=(StringArena&& other)
+{
+    if (this != &other) {
+        this->blocks = std::move(other.blocks);
+        this->used = other.used;
+        this->capacity = other.capacity;
+        this->total = other.total;
+        this->reserved = other.reserved;
+
+        other.blocks.clear();
+        other.used = other.capacity = other.total = other.reserved = 0;
+    }
+    return *this;
+}
+
+std::string_view StringArena::store(std::string_view s)
+{
+    if (s.empty()) return std::string_view();
+
+    if (this->capacity - this->used < s.size()) {
+        // blocs de taille croissante, jusqu'à STRING_ARENA_BLOCK
+        const size_t grown = this->blocks.empty() ? STRING_ARENA_FIRST_BLOCK
+                                                  : std::min(this->capacity * 2, STRING_ARENA_BLOCK);
+        const size_t size = std::max({grown, this->reserved, s.size()});
+
+        this->blocks.emplace_back(new char[size]);
+        this->capacity = size;
+        this->used = 0;
+        this->reserved = 0;
+    }
+
+    char* dst = this->blocks.back().get() + this->used;
+    std::memcpy(dst, s.data(), s.size());
+    this->used += s.size();
+    this->total += s.size();
+    return std::string_view(dst, s.size());
+}
+
+void StringArena::reserve(size_t n)
+{
+    if (this->capacity - this->used < n)
+        this->reserved = std::max(this->reserved, n);
+}
+
+void StringArena::clear()
+{
+    this->blocks.clear();
+    this->used = 0;
+    this->capacity = 0;
+    this->total = 0;
+    this->reserved = 0;
+}
+
+/* -------------------- StringColumn -------------------- */
+
+StringColumn::StringColumn()
+{
+    this->dictionaryEncoded = false;
+    this->deadBytes = 0;
+}
+
+StringColumn::StringColumn(const StringColumn& other)
+    : StringColumn()
+{
+    *this = other;
+}
+
+StringColumn& StringColumn::operator=(const StringColumn& other)
+{
+    if (this == &other) return *this;
+
+    this->clear();
+    this->dictionaryEncoded = other.dictionaryEncoded;
+    this->arena.reserve(other.arena.bytes() - other.deadBytes);
+
+    // les vues de other pointent dans other.arena : on recopie les octets
+    if (other.dictionaryEncoded) {
+        for (std::string_view s : other.dictionary) this->codeOf(s);
+        this->codes = other.codes;
+    } else {
+        this->rows.reserve(other.rows.size());
+        for (std::string_view s : other.rows) this->rows.push_back(this->arena.store(s));
+    }
+    return *this;
+}
+
+uint32_t StringColumn::codeOf(std::string_view s)
+{
+    auto it = this->lookup.find(s);
+    if (it != this->lookup.end()) return it->second;
+
+    const uint32_t code = static_cast<uint32_t>(this->dictionary.size());
+    this->dictionary.push_back(this->arena.store(s));
+    this->lookup.emplace(this->dictionary.back(), code);
+    return code;
+}
+
+void StringColumn::release(std::string_view s)
+{
+    this->deadBytes += s.size();
+    this->compactIfWasteful();
+}
+
+void StringColumn::compactIfWasteful()
+{
+    if (this->deadBytes > STRING_ARENA_BLOCK && this->deadBytes * 2 > this->arena.bytes())
+        this->compact();
+}
+
+void StringColumn::compact()
+{
+    StringArena fresh;
+    fresh.reserve(this->arena.bytes() - this->deadBytes);
+    for (std::string_view& s : this->rows) s = fresh.store(s);
+
+    this->arena = std::move(fresh);
+    this->deadBytes = 0;
+}
+
+void StringColumn::reserve(size_t n)
+{
+    if (this->dictionaryEncoded) this->codes.reserve(n);
+    else this->rows.reserve(n);
+}
+
+void StringColumn::reserveBytes(size_t n)
+{
+    this->arena.reserve(n);
+}
+
+void StringColumn::push_back(std::string_view s)
+{
+    if (this->dictionaryEncoded) this->codes.push_back(this->codeOf(s));
+    else this->rows.push_back(this->arena.store(s));
+}
+
+void StringColumn::emplace_back()
+{
+    this->push_back(std::string_view());
+}
+
+void StringColumn::set(size_t i, std::string_view s)
+{
+    if (this->dictionaryEncoded) {
+        this->codes[i] = this->codeOf(s);
+    } else {
+        const std::string_view old = this->rows[i];
+        this->rows[i] = this->arena.store(s);
+        this->release(old);
+    }
+}
+
+void StringColumn::erase(size_t i)
+{
+    if (this->dictionaryEncoded) {
+        this->codes.erase(this->codes.begin() + static_cast<std::ptrdiff_t>(i));
+    } else {
+        const std::string_view old = this->rows[i];
+        this->rows.erase(this->rows.begin() + static_cast<std::ptrdiff_t>(i));
+        this->release(old);
+    }
+}
+
+void StringColumn::clear()
+{
+    this->arena.clear();
+    this->deadBytes = 0;
+    this->rows.clear();
+    this->dictionary.clear();
+    this->lookup.clear();
+    this->codes.clear();
+}
+
+void StringColumn::append(const StringColumn& other)
+{
+    if (&other == this) {
+        const StringColumn copy = other;
+        this->append(copy);
+        return;
+    }
+
+    if (this->dictionaryEncoded && other.dictionaryEncoded) {
+        // un code de other -> un code d'ici, calculé une fois par entrée du dictionnaire
+        std::vector<uint32_t> remap(other.dictionary.size());
+        for (size_t c = 0; c < other.dictionary.size(); ++c)
+            remap[c] = this->codeOf(other.dictionary[c]);
+
+        this->codes.reserve(this->codes.size() + other.codes.size());
+        for (uint32_t c : other.codes) this->codes.push_back(remap[c]);
+    } else {
+        if (!this->dictionaryEncoded && !other.dictionaryEncoded)
+            this->arena.reserve(other.arena.bytes() - other.deadBytes);
+
+        this->reserve(this->size() + other.size());
+        for (size_t i = 0; i < other.size(); ++i) this->push_back(other[i]);
+    }
+}
+
+void StringColumn::appendRows(const StringColumn& other, const std::vector<uint32_t>& rows)
+{
+    if (&other == this) {
+        const StringColumn copy = other;
+        this->appendRows(copy, rows);
+        return;
+    }
+
+    const size_t n = other.size();
+    this->reserve(this->size() + rows.size());
+    if (this->dictionaryEncoded && other.dictionaryEncoded) {
+        // traduction paresseuse : seules les entrées réellement choisies passent par codeOf
+        const uint32_t unknown = std::numeric_limits<uint32_t>::max();
+        std::vector<uint32_t> remap(other.dictionary.size(), unknown);
+        for (uint32_t r : rows) {
+            if (r >= n) {
+                this->codes.push_back(this->codeOf(std::string_view()));
+                continue;
+            }
+            uint32_t& code = remap[other.codes[r]];
+            if (code == unknown) code = this->codeOf(other.dictionary[other.codes[r]]);
+            this->codes.push_back(code);
+        }
+    } else {
+        for (uint32_t r : rows) this->push_back(r < n ? other[r] : std::string_view());
+    }
+}
+
+void StringColumn::encodeDictionary()
+{
+    if (this->dictionaryEncoded) return;
+
+    // le dictionnaire part dans une arène neuve, les octets des lignes sont libérés en fin de bloc
+    const StringArena old = std::move(this->arena);
+    const std::vector<std::string_view> plain = std::move(this->rows);
+    this->rows = std::vector<std::string_view>();
+
+    this->codes.reserve(plain.size());
+    for (std::string_view s : plain) this->codes.push_back(this->codeOf(s));
+
+    this->deadBytes = 0;
+    this->dictionaryEncoded = true;
+}
+
+void StringColumn::decodeDictionary()
+{
+    if (!this->dictionaryEncoded) return;
+
+    // les lignes pointent sur les octets du dictionnaire, qui restent dans l'arène
+    this->rows.reserve(this->codes.size());
+    for (uint32_t c : this->codes) this->rows.push_back(this->dictionary[c]);
+
+    this->dictionary = std::vector<std::string_view>();
+    this->lookup = std::unordered_map<std::string_view, uint32_t>();
+    this->codes = std::vector<uint32_t>();
+    this->deadBytes = 0;
+    this->dictionaryEncoded = false;
+}
+
+size_t StringColumn::cardinality() const
+{
+    if (this->dictionaryEncoded) return this->dictionary.size();
+
+    std::unordered_set<std::string_view> distinct(this->rows.begin(), this->rows.end());
+    return distinct.size();
+}
+
+bool StringColumn::findCode(std::string_view s, uint32_t& code) const
+{
+    auto it = this->lookup.find(s);
+    if (it == this->lookup.end()) return false;
+    code = it->second;
+    return true;
+}
+
+std::vector<uint32_t> StringColumn::sortedRanks() const
+{
+    std::vector<uint32_t> order(this->dictionary.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+        [this](uint32_t a, uint32_t b) { return this->dictionary[a] < this->dictionary[b]; });
+
+    std::vector<uint32_t> rank(order.size());
+    for (size_t r = 0; r < order.size(); ++r) rank[order[r]] = static_cast<uint32_t>(r);
+    return rank;
+}
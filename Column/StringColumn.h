@@ -0,0 +1,259 @@
+#ifndef STRING_COLUMN_H
+#define STRING_COLUMN_H
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief A dictionary-encoded column is turned back into plain strings when it
+ *        holds more than one distinct value per DICTIONARY_MAX_RATIO rows
+ */
+const size_t DICTIONARY_MAX_RATIO = 2;
+
+/**
+ * @brief Number of rows after which the CSV loaders check the cardinality of a
+ *        dictionary-encoded column for the first time
+ */
+const size_t DICTIONARY_SAMPLE_ROWS = 4096;
+
+/**
+ * @brief Size of a StringArena block (a longer string gets a block of its own)
+ */
+const size_t STRING_ARENA_BLOCK = 1 << 20;
+
+/**
+ * @class StringArena
+ * @brief Append-only byte storage for the strings of a column.
+ *
+ * Strings are copied back to back into blocks of STRING_ARENA_BLOCK bytes.
+ * Blocks are never moved nor freed before the arena itself (moving the arena
+ * keeps them too), so a view returned by store() stays valid as long as the
+ * arena holds it, and destroying a column frees a few blocks instead of one
+ * allocation per row.
+ */
+class StringArena {
+private:
+    std::vector<std::unique_ptr<char[]>> blocks;
+    size_t used;     // octets occupés dans le dernier bloc
+    size_t capacity; // taille du dernier bloc
+    size_t total;    // octets stockés depuis le dernier clear()
+    size_t reserved; // taille minimale du prochain bloc
+
+public:
+    StringArena();
+    StringArena(StringArena&& other);
+    StringArena& operator=(StringArena&& other);
+
+    /**
+     * @brief Copy a string into the arena
+     * @return View on the stored bytes (an empty view for an empty string)
+     */
+    std::string_view store(std::string_view s);
+
+    /**
+     * @brief Make sure the next `n` bytes stored fit in a single block
+     */
+    void reserve(size_t n);
+
+    /**
+     * @brief Number of bytes stored
+     */
+    size_t bytes() const { return this->total; }
+
+    /**
+     * @brief Free every block (all views become invalid)
+     */
+    void clear();
+};
+
+
+/**
+ * @class StringColumn
+ * @brief Typed buffer of a STRING column, plain or dictionary-encoded.
+ *
+ * Plain: the bytes of every row live in a StringArena and each row is a
+ * view on them. Replacing or removing a row leaves its old bytes in the
+ * arena; the arena is compacted once they outweigh the live ones.
+ * Dictionary: each distinct string is stored once, and every row holds a
+ * 32-bit code into the dictionary (codes follow the order in which the
+ * strings first appeared). Equality on the codes is equality on the strings.
+ *
+ * Both encodings expose the same read interface (`operator[]` returns a view
+ * on the string of a row, valid until the column is modified), so code
+ * visiting a ColumnStorage buffer works on either.
+ */
+class StringColumn {
+public:
+    using value_type = std::string;
+
+private:
+    bool dictionaryEncoded;
+
+    // octets des lignes (plain) ou des entrées du dictionnaire
+    StringArena arena;
+    size_t deadBytes;
+
+    // plain
+    std::vector<std::string_view> rows;
+
+    // dictionary
+    std::vector<std::string_view> dictionary;
+    std::unordered_map<std::string_view, uint32_t> lookup;
+    std::vector<uint32_t> codes;
+
+    /**
+     * @brief Code of a string, added to the dictionary if needed
+     */
+    uint32_t codeOf(std::string_view s);
+
+    /**
+     * @brief Count the bytes of a plain row that is being replaced or removed
+     */
+    void release(std::string_view s);
+
+    /**
+     * @brief Compact the arena once the dead bytes outweigh the live ones
+     */
+    void compactIfWasteful();
+
+    /**
+     * @brief Copy the live rows into a fresh arena (plain encoding)
+     */
+    void compact();
+
+public:
+    StringColumn();
+    StringColumn(const StringColumn& other);
+    StringColumn(StringColumn&& other) = default;
+    StringColumn& operator=(const StringColumn& other);
+    StringColumn& operator=(StringColumn&& other) = default;
+
+    size_t size() const { return this->dictionaryEncoded ? this->codes.size() : this->rows.size(); }
+    bool empty() const { return this->size() == 0; }
+
+    /**
+     * @brief String of a row
+     */
+    std::string_view operator[](size_t i) const
+    {
+        return this->dictionaryEncoded ? this->dictionary[this->codes[i]] : this->rows[i];
+    }
+
+    void reserve(size_t n);
+
+    /**
+     * @brief Reserve room for `n` more bytes of string data in a single block
+     */
+    void reserveBytes(size_t n);
+
+    /**
+     * @brief Append a row, copying its bytes into the arena
+     */
+    void push_back(std::string_view s);
+
+    /**
+     * @brief Append an empty string (placeholder of a NULL row)
+     */
+    void emplace_back();
+
+    /**
+     * @brief Replace the string of a row
+     */
+    void set(size_t i, std::string_view s);
+
+    /**
+     * @brief Remove a row
+     */
+    void erase(size_t i);
+
+    void clear();
+
+    /**
+     * @brief Remove every row i for which removed(i) is true, in one pass
+     */
+    template <typename F>
+    void removeIf(F removed)
+    {
+        size_t kept = 0;
+        if (this->dictionaryEncoded) {
+            for (size_t i = 0; i < this->codes.size(); ++i)
+                if (!removed(i)) this->codes[kept++] = this->codes[i];
+            this->codes.resize(kept);
+        } else {
+            for (size_t i = 0; i < this->rows.size(); ++i) {
+                if (removed(i)) this->deadBytes += this->rows[i].size();
+                else this->rows[kept++] = this->rows[i];
+            }
+            this->rows.resize(kept);
+            this->compactIfWasteful();
+        }
+    }
+
+    /**
+     * @brief Append all rows of another column, whatever its encoding
+     */
+    void append(const StringColumn& other);
+
+    /**
+     * @brief Append rows of another column picked by row number, whatever its encoding
+     *
+     * Between two dictionary-encoded columns, codes are translated once per
+     * dictionary entry instead of once per row.
+     *
+     * @param rows Row of `other` for each appended row; a row past its end appends an empty string
+     */
+    void appendRows(const StringColumn& other, const std::vector<uint32_t>& rows);
+
+    // ----- encoding -----
+
+    /**
+     * @brief true if the rows are stored as dictionary codes
+     */
+    bool isDictionary() const { return this->dictionaryEncoded; }
+
+    /**
+     * @brief Switch to the dictionary encoding (no-op if already encoded)
+     */
+    void encodeDictionary();
+
+    /**
+     * @brief Switch to plain strings (no-op if already plain)
+     */
+    void decodeDictionary();
+
+    /**
+     * @brief Number of distinct strings (size of the dictionary when encoded)
+     */
+    size_t cardinality() const;
+
+    /**
+     * @brief Codes of the rows (dictionary encoding only)
+     */
+    const std::vector<uint32_t>& getCodes() const { return this->codes; }
+
+    /**
+     * @brief Strings of the dictionary, indexed by code (dictionary encoding only)
+     */
+    const std::vector<std::string_view>& getDictionary() const { return this->dictionary; }
+
+    /**
+     * @brief Look up the code of a string (dictionary encoding only)
+     * @return false if the string is not in the dictionary
+     */
+    bool findCode(std::string_view s, uint32_t& code) const;
+
+    /**
+     * @brief Rank of every code in the sorted dictionary (dictionary encoding only)
+     *
+     * Ranks follow std::string ordering, so sorting rows by the rank of their
+     * code sorts them by their string.
+     */
+    std::vector<uint32_t> sortedRanks() const;
+};
+
+#endif
@@ -0,0 +1,237 @@
+#ifndef TYPED_COLUMN_H
+#define TYPED_COLUMN_H
+
+#include "ColumnValue.h"
+#include "StringColumn.h"
+#include "ValidityBitmap.h"
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <ostream>
+#include <type_traits>
+#include <variant>
+#include <any>
+
+/**
+ * @brief Buffer holding the values of a column whose element type is T
+ *
+ * `std::vector<T>` for the fixed-width types and OBJECT, StringColumn for
+ * STRING, nothing (std::monostate) for NULLVAL.
+ */
+template <typename T> struct TypedBuffer { using type = std::vector<T>; };
+template <> struct TypedBuffer<std::string> { using type = StringColumn; };
+template <> struct TypedBuffer<std::monostate> { using type = std::monostate; };
+
+/**
+ * @brief Element type stored in a buffer (the reverse of TypedBuffer)
+ */
+template <typename V> struct BufferElement { using type = typename V::value_type; };
+template <> struct BufferElement<std::monostate> { using type = std::monostate; };
+
+/**
+ * @brief Text of any value, as insertValueAuto stores it in a STRING column
+ */
+inline std::string autoToString(const ColumnValue& x)
+{
+    return std::visit([](auto&& arg) -> std::string {
+        using T = std::decay_t<decltype(arg)>;
+
+        if constexpr (std::is_same_v<T, std::monostate>) {
+            return "NULL";
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            return arg;
+        } else if constexpr (std::is_same_v<T, std::any>) {
+            return "[object]";
+        } else if constexpr (std::is_same_v<T, std::uint8_t> || std::is_same_v<T, std::int8_t>) {
+            return std::to_string(static_cast<int>(arg));
+        } else if constexpr (std::is_arithmetic_v<T>) {
+            return std::to_string(arg);
+        } else {
+            return "[unsupported]";
+        }
+    }, x);
+}
+
+/**
+ * @brief Numeric value of any value, std::nullopt for NULL / string / object
+ */
+inline std::optional<long double> autoToNumber(const ColumnValue& x)
+{
+    return std::visit([](auto&& arg) -> std::optional<long double> {
+        using T = std::decay_t<decltype(arg)>;
+        if constexpr (std::is_arithmetic_v<T>)
+            return static_cast<long double>(arg);
+        else
+            return std::nullopt;
+    }, x);
+}
+
+/**
+ * @class TypedColumn
+ * @brief View on the values and validity of a column whose element type T is
+ *        known at compile time.
+ *
+ * ColumnStorage::typed resolves the element type once and hands the operation
+ * a TypedColumn<T>; every cell it touches is then read, converted or formatted
+ * with T fixed, without going back through ColumnValue or a type switch.
+ * There is one instantiation per ColumnType (std::monostate for NULLVAL,
+ * std::string for STRING, std::any for OBJECT).
+ *
+ * `TypedColumn<const T>` is the read-only view, like `std::span<const T>`.
+ * A view is invalidated by anything that reallocates the column.
+ */
+template <typename T>
+class TypedColumn {
+public:
+    using element_type = std::remove_const_t<T>;
+    using buffer_type = std::conditional_t<std::is_const_v<T>,
+                                           const typename TypedBuffer<element_type>::type,
+                                           typename TypedBuffer<element_type>::type>;
+    using validity_type = std::conditional_t<std::is_const_v<T>, const ValidityBitmap, ValidityBitmap>;
+
+private:
+    buffer_type* values;
+    validity_type* validity;
+
+    static constexpr bool isNull = std::is_same_v<element_type, std::monostate>;
+
+public:
+    TypedColumn(buffer_type& values, validity_type& validity)
+        : values(&values), validity(&validity) {}
+
+    /**
+     * @brief Typed buffer of the column
+     */
+    buffer_type& buffer() const { return *this->values; }
+
+    /**
+     * @brief Number of rows
+     */
+    size_t size() const { return this->validity->size(); }
+
+    /**
+     * @brief Test whether a row holds a value
+     */
+    bool isValid(size_t i) const { return this->validity->test(i); }
+
+    /**
+     * @brief Check that a value can be stored as is (std::nullopt is always accepted)
+     */
+    static bool accepts(const std::optional<ColumnValue>& value)
+    {
+        return !value.has_value() || std::holds_alternative<element_type>(*value);
+    }
+
+    /**
+     * @brief Append a NULL row
+     */
+    void appendNull()
+    {
+        if constexpr (!isNull) this->values->emplace_back();
+        this->validity->push_back(false);
+    }
+
+    /**
+     * @brief Append a value of the element type, without conversion
+     * @return false (nothing appended) if accepts(value) is false
+     */
+    bool insert(std::optional<ColumnValue> value)
+    {
+        if (!accepts(value)) return false;
+
+        if constexpr (isNull) {
+            this->validity->push_back(false);
+        } else {
+            if (!value.has_value()) {
+                this->appendNull();
+                return true;
+            }
+            this->values->push_back(std::get<element_type>(std::move(*value)));
+            this->validity->push_back(true);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Append a value converted to the element type
+     *
+     * NULL is accepted everywhere; a STRING column stores the text of any
+     * value, an OBJECT column wraps it in std::any, a numeric column casts
+     * any numeric value (a string or an object is refused).
+     *
+     * @return false (nothing appended) if the value cannot be converted
+     */
+    bool insertAuto(const ColumnValue& value)
+    {
+        if (std::holds_alternative<std::monostate>(value)) {
+            this->appendNull();
+            return true;
+        }
+
+        if constexpr (isNull) {
+            return false;
+        } else {
+            if constexpr (std::is_same_v<element_type, std::string>) {
+                if (const std::string* s = std::get_if<std::string>(&value)) this->values->push_back(*s);
+                else this->values->push_back(autoToString(value));
+            } else if constexpr (std::is_same_v<element_type, std::any>) {
+                if (const std::any* a = std::get_if<std::any>(&value)) this->values->push_back(*a);
+                else this->values->push_back(std::any(value));
+            } else if (const element_type* same = std::get_if<element_type>(&value)) {
+                this->values->push_back(*same);
+            } else {
+                const std::optional<long double> n = autoToNumber(value);
+                if (!n) return false;
+                this->values->push_back(static_cast<element_type>(*n));
+            }
+            this->validity->push_back(true);
+            return true;
+        }
+    }
+
+    /**
+     * @brief Materialize a row as a ColumnValue
+     * @return The value, or std::nullopt if the row is NULL
+     */
+    std::optional<ColumnValue> get(size_t i) const
+    {
+        if constexpr (isNull) {
+            return std::nullopt;
+        } else {
+            if (!this->isValid(i)) return std::nullopt;
+            return ColumnValue(std::in_place_type<element_type>, (*this->values)[i]);
+        }
+    }
+
+    /**
+     * @brief Text of a valid row ("NULL" for a NULLVAL column)
+     */
+    std::string toString(size_t i) const
+    {
+        if constexpr (isNull) {
+            return "NULL";
+        } else if constexpr (std::is_same_v<element_type, std::string>) {
+            return std::string((*this->values)[i]);
+        } else if constexpr (std::is_same_v<element_type, std::any>) {
+            return "[object]";
+        } else if constexpr (std::is_same_v<element_type, std::uint8_t> || std::is_same_v<element_type, std::int8_t>) {
+            // éviter l'affichage en caractère
+            return std::to_string(static_cast<int>((*this->values)[i]));
+        } else {
+            return std::to_string((*this->values)[i]);
+        }
+    }
+
+    /**
+     * @brief Write a valid row to a stream, like toString but without copying strings
+     */
+    void write(std::ostream& out, size_t i) const
+    {
+        if constexpr (std::is_same_v<element_type, std::string>) out << (*this->values)[i];
+        else out << this->toString(i);
+    }
+};
+
+#endif
@@ -0,0 +1,182 @@
+// ========================= ValidityBitmap.cpp =========================
+#include <iterator>
+
+#include "ValidityBitmap.h"
+
+static size_t popcount(uint64_t w)
+{
+#if defined(__GNUC__)
+    return static_cast<size_t>(__builtin_popcountll(w));
+#else
+    size_t c = 0;
+    while (w) { w &= w - 1; c++; }
+    return c;
+#endif
+}
+
+ValidityBitmap::ValidityBitmap()
+{
+    this->words = std::vector<uint64_t>();
+    this->count = 0;
+    this->nulls = 0;
+}
+
+void ValidityBitmap::push_back(bool valid)
+{
+    if ((this->count & 63) == 0)
+        this->words.push_back(0);
+
+    if (valid) this->words[this->count >> 6] |= (uint64_t{1} << (this->count & 63));
+    else this->nulls++;
+
+    this->count++;
+}
+
+void ValidityBitmap::set(size_t i, bool valid)
+{
+    const uint64_t mask = uint64_t{1} << (i & 63);
+    const bool wasValid = (this->words[i >> 6] & mask) != 0;
+    if (wasValid == valid) return;
+
+    if (valid) {
+        this->words[i >> 6] |= mask;
+        this->nulls--;
+    } else {
+        this->words[i >> 6] &= ~mask;
+        this->nulls++;
+    }
+}
+
+void ValidityBitmap::erase(size_t i)
+{
+    if (!this->test(i)) this->nulls--;
+
+    const size_t w = i >> 6;
+    const uint64_t bit = i & 63;
+
+    // mot contenant i : on garde les bits bas, on décale les bits hauts
+    const uint64_t low = bit == 0 ? 0 : (this->words[w] & ((uint64_t{1} << bit) - 1));
+    const uint64_t high = bit == 63 ? 0 : ((this->words[w] >> (bit + 1)) << bit);
+    this->words[w] = low | high;
+
+    // les mots suivants descendent d'un bit, avec retenue vers le mot précédent
+    for (size_t k = w + 1; k < this->words.size(); ++k) {
+        this->words[k - 1] |= (this->words[k] & 1u) << 63;
+        this->words[k] >>= 1;
+    }
+
+    this->count--;
+    if ((this->count & 63) == 0)
+        this->words.pop_back();
+}
+
+void ValidityBitmap::reserve(size_t n)
+{
+    this->words.reserve((n + 63) / 64);
+}
+
+void ValidityBitmap::append(const ValidityBitmap& other)
+{
+    if (other.count == 0) return;
+
+    const size_t shift = this->count & 63;
+    if (shift == 0) {
+        // alignement sur un mot : copie directe
+        this->words.insert(this->words.end(), other.words.begin(), other.words.end());
+    } else {
+        for (uint64_t w : other.words) {
+            this->words.back() |= w << shift;
+            this->words.push_back(w >> (64 - shift));
+        }
+    }
+
+    this->count += other.count;
+    this->nulls += other.nulls;
+    this->words.resize((this->count + 63) / 64);
+}
+
+size_t ValidityBitmap::countValid(size_t begin, size_t end) const
+{
+    if (end > this->count) end = this->count;
+    if (begin >= end) return 0;
+    if (begin == 0 && end == this->count) return this->count - this->nulls;
+
+    const size_t first = begin >> 6;
+    const size_t last = (end - 1) >> 6;
+    const uint64_t head = ~uint64_t{0} << (begin & 63);
+    const uint64_t tail = (end & 63) == 0 ? ~uint64_t{0} : ((uint64_t{1} << (end & 63)) - 1);
+
+    if (first == last) return popcount(this->words[first] & head & tail);
+
+    size_t valid = popcount(this->words[first] & head) + popcount(this->words[last] & tail);
+    for (size_t w = first + 1; w < last; ++w) valid += popcount(this->words[w]);
+    return valid;
+}
+
+void ValidityBitmap::resize(size_t n)
+{
+    if (n <= this->count) return;
+
+    this->words.resize((n + 63) / 64, 0);
+    this->nulls += n - this->count;
+    this->count = n;
+}
+
+void ValidityBitmap::removeRows(const ValidityBitmap& removed)
+{
+    // écriture en place : la ligne gardée k arrive toujours à une position <= k
+    size_t kept = 0;
+    this->nulls = 0;
+    for (size_t i = 0; i < this->count; ++i) {
+        if (i < removed.count && removed.test(i)) continue;
+
+        const uint64_t mask = uint64_t{1} << (kept & 63);
+        if (this->test(i)) {
+            this->words[kept >> 6] |= mask;
+        } else {
+            this->words[kept >> 6] &= ~mask;
+            this->nulls++;
+        }
+        kept++;
+    }
+
+    this->count = kept;
+    this->words.resize((kept + 63) / 64);
+    if ((kept & 63) != 0) this->words.back() &= (uint64_t{1} << (kept & 63)) - 1;
+}
+
+ValidityBitmap ValidityBitmap::maskedRange(size_t begin, size_t end, const ValidityBitmap& removed) const
+{
+    ValidityBitmap out;
+    if (end > this->count) end = this->count;
+    const size_t first = begin >> 6;
+    if (begin >= end) return out;
+
+    const size_t last = (end + 63) >> 6;
+    out.words.assign(this->words.begin() + static_cast<std::ptrdiff_t>(first),
+                     this->words.begin() + static_cast<std::ptrdiff_t>(last));
+    for (size_t w = first; w < last && w < removed.words.size(); ++w)
+        out.words[w - first] &= ~removed.words[w];
+
+    out.count = end - first * 64;
+    if ((out.count & 63) != 0) out.words.back() &= (uint64_t{1} << (out.count & 63)) - 1;
+
+    size_t valid = 0;
+    for (uint64_t w : out.words) valid += popcount(w);
+    out.nulls = out.count - valid;
+    return out;
+}
+
+void ValidityBitmap::assign(const uint64_t* src, size_t n)
+{
+    this->words.assign(src, src + (n + 63) / 64);
+    this->count = n;
+
+    // on ne garde aucun bit au-delà de n
+    if ((n & 63) != 0)
+        this->words.back() &= (uint64_t{1} << (n & 63)) - 1;
+
+    size_t valid = 0;
+    for (uint64_t w : this->words) valid += popcount(w);
+    this->nulls = n - valid;
+}
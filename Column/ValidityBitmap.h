@@ -0,0 +1,129 @@
+#ifndef VALIDITY_BITMAP_H
+#define VALIDITY_BITMAP_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class ValidityBitmap
+ * @brief Packed bitset telling which rows of a column hold a value.
+ *
+ * Bit `i` is set when row `i` is valid (not NULL). Bits are stored in 64-bit
+ * words so that scans can skip fully-valid or fully-null words at once.
+ */
+class ValidityBitmap {
+private:
+    std::vector<uint64_t> words;
+    size_t count;
+    size_t nulls;
+
+public:
+    ValidityBitmap();
+
+    /**
+     * @brief Number of rows tracked by the bitmap
+     */
+    size_t size() const { return this->count; }
+
+    /**
+     * @brief Number of NULL rows
+     */
+    size_t nullCount() const { return this->nulls; }
+
+    /**
+     * @brief Test whether a row holds a value
+     * @param i Row index (must be < size())
+     * @return true if the row is valid, false if it is NULL
+     */
+    bool test(size_t i) const { return (this->words[i >> 6] >> (i & 63)) & 1u; }
+
+    /**
+     * @brief Raw 64-bit words (bit i of word i/64 is row i)
+     */
+    const std::vector<uint64_t>& raw() const { return this->words; }
+
+    /**
+     * @brief Call `f(i)` for every set row i < min(end, size()), in increasing order
+     *
+     * Words are scanned one at a time, so a sparse bitmap costs one test per 64 rows.
+     */
+    template <typename F>
+    void forEachSet(size_t end, F&& f) const
+    {
+        if (end > this->count) end = this->count;
+        for (size_t w = 0; w * 64 < end; ++w) {
+            uint64_t m = this->words[w];
+            if (end - w * 64 < 64) m &= (uint64_t{1} << (end - w * 64)) - 1;
+            for (; m; m &= m - 1) {
+#if defined(__GNUC__)
+                f(w * 64 + static_cast<size_t>(__builtin_ctzll(m)));
+#else
+                size_t j = 0;
+                while (!((m >> j) & 1u)) j++;
+                f(w * 64 + j);
+#endif
+            }
+        }
+    }
+
+    /**
+     * @brief Append a row
+     * @param valid true for a value, false for NULL
+     */
+    void push_back(bool valid);
+
+    /**
+     * @brief Change the validity of an existing row
+     */
+    void set(size_t i, bool valid);
+
+    /**
+     * @brief Remove a row, shifting the following rows down by one
+     */
+    void erase(size_t i);
+
+    /**
+     * @brief Reserve room for n rows
+     */
+    void reserve(size_t n);
+
+    /**
+     * @brief Append all rows of another bitmap
+     */
+    void append(const ValidityBitmap& other);
+
+    /**
+     * @brief Number of valid rows in [begin, end)
+     */
+    size_t countValid(size_t begin, size_t end) const;
+
+    /**
+     * @brief Grow to n rows, the new rows being NULL (no-op if n <= size())
+     */
+    void resize(size_t n);
+
+    /**
+     * @brief Remove every row set in `removed`, in one pass
+     * @param removed Rows to remove (bit set); rows past its end are kept
+     */
+    void removeRows(const ValidityBitmap& removed);
+
+    /**
+     * @brief Copy of the rows [begin, end) with the rows set in `removed` cleared
+     *
+     * The copy starts on the word holding `begin`: its row r is row
+     * r + 64 * (begin / 64) here, so word-based scans can run on it unchanged.
+     * Rows past the end of `removed` keep their bit.
+     */
+    ValidityBitmap maskedRange(size_t begin, size_t end, const ValidityBitmap& removed) const;
+
+    /**
+     * @brief Replace the content with raw words
+     * @param src Packed words, in the raw() layout
+     * @param n Number of rows described by src
+     */
+    void assign(const uint64_t* src, size_t n);
+};
+
+#endif
@@ -0,0 +1,424 @@
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Column/Column.h"
+#include "CDataframe/CDataframe.h"
+#include "CDataframe/LazyFrame.h"
+
+// Vérifications de comportement : chaque CHECK raté est affiché, le programme sort en erreur s'il y en a un
+static int failures = 0;
+
+#define CHECK(cond)                                                              \
+    do {                                                                         \
+        if (!(cond)) {                                                           \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond ") failed\n"; \
+            failures++;                                                          \
+        }                                                                        \
+    } while (0)
+
+/**
+ * Live rows of a frame, one string per row ("a|b|..."), in row order.
+ */
+static std::vector<std::string> dump(const CDataframe& df)
+{
+    ValidityBitmap all;
+    for (size_t i = 0; i < df.getRowsCount(); ++i) all.push_back(true);
+    std::unique_ptr<CDataframe> copy = df.filter(all);
+
+    std::vector<std::string> rows(copy->getRowsCount());
+    for (size_t c = 0; c < copy->getColumnsCount(); ++c) {
+        std::shared_ptr<Column> col = copy->getColumnByIndex(c);
+        for (size_t r = 0; r < rows.size(); ++r) rows[r] += (c ? "|" : "") + col->valueToString(r);
+    }
+    return rows;
+}
+
+/**
+ * Frame of two INT columns "a" = 0, 1, ..., n - 1 and "b" = 10, 11, ...
+ */
+static CDataframe sequenceFrame(int n)
+{
+    CDataframe df({ColumnType::INT, ColumnType::INT});
+    df.setColumnNames({"a", "b"});
+    for (int i = 0; i < n; ++i) df.insertRow({int32_t(i), int32_t(10 + i)});
+    return df;
+}
+
+// exist, searchValue, occurence et findRows : une cellule NaN est égale à toute sonde comparable
+static void checkNaNLookups()
+{
+    for (bool withNaN : {false, true}) {
+        Column col("x", ColumnType::DOUBLE);
+        for (double v : {4.0, 1.0, 7.0, 2.5}) col.insertValue(v);
+        if (withNaN) col.insertValue(std::nan(""));
+        col.insertValue(std::nullopt);
+        col.sort(true);
+
+        for (const ColumnValue& probe : {ColumnValue(1.0), ColumnValue(3.0), ColumnValue(-10.0), ColumnValue(100),
+                                        ColumnValue(std::nan(""))}) {
+            const int occurrences = col.occurence(probe);
+            CHECK(col.searchValue(probe) == (occurrences > 0 ? 1 : 0));
+            CHECK(col.exist(probe) == (occurrences > 0));
+            CHECK(col.findRows(probe).size() == static_cast<size_t>(occurrences));
+        }
+        // une sonde entre les bornes ou au-delà : trouvée seulement grâce à la cellule NaN
+        CHECK(col.exist(3.0) == withNaN);
+        CHECK(col.exist(-10.0) == withNaN);
+        CHECK(col.exist(std::string("a")) == false);
+    }
+}
+
+// tombstones : une ligne supprimée disparaît des comptages, le seuil de compaction retire physiquement les lignes
+static void checkTombstones()
+{
+    CDataframe df = sequenceFrame(8);
+    df.setDeletionMode(RowDeletionMode::TOMBSTONE);
+
+    CHECK(df.deleteRow(2));
+    CHECK(df.getDeletedRowsCount() == 1);
+    CHECK(df.getRowsCount() == 7);
+    CHECK(df.getColumnByName("a")->getSize() == 8);  // seulement marquée
+    CHECK(df.numberOfCellsEqualTo(2) == 0);
+    CHECK(df.numberOfCellsEqualTo(12) == 0);
+    CHECK(!df.exist(12));
+    CHECK(df.numberOfCellsGreaterThan(5) == 2 + 7);
+    CHECK(df.numberOfCellsLowerThan(3) == 2);
+    CHECK(dump(df).front() == "0|10" && dump(df)[2] == "3|13");
+
+    // 2 lignes supprimées sur 8 : TOMBSTONE_COMPACT_RATIO (1/4) atteint, compaction
+    CHECK(df.deleteRow(0));
+    CHECK(df.getDeletedRowsCount() == 0);
+    CHECK(df.getRowsCount() == 6);
+    CHECK(df.getColumnByName("a")->getSize() == 6);
+    CHECK(dump(df) == std::vector<std::string>({"1|11", "3|13", "4|14", "5|15", "6|16", "7|17"}));
+
+    // sous le seuil après compaction : de nouveau un simple marquage
+    CHECK(df.deleteRow(5));
+    CHECK(df.getDeletedRowsCount() == 1);
+    CHECK(df.numberOfCellsEqualTo(7) == 0);
+    df.compact();
+    CHECK(df.getDeletedRowsCount() == 0 && df.getColumnByName("b")->getSize() == 5);
+}
+
+// sélections : un bit par ligne vivante ; une vue montre les mêmes lignes qu'une copie sans rien copier
+static void checkSelections()
+{
+    CDataframe df = sequenceFrame(10);
+    df.setDeletionMode(RowDeletionMode::TOMBSTONE);
+    CHECK(df.deleteRow(1));
+
+    ValidityBitmap selection;
+    CHECK(df.select({ColumnPredicate::greater("a", 2), ColumnPredicate::lower("b", 17)}, PredicateCombine::AND, selection));
+    CHECK(selection.size() == 9);
+    CHECK(selection.countValid(0, selection.size()) == 4);  // a = 3, 4, 5, 6
+    CHECK(!selection.test(1) && selection.test(2) && selection.test(5) && !selection.test(6));
+
+    CHECK(df.select({ColumnPredicate::equal("a", 1), ColumnPredicate::equal("a", 0), ColumnPredicate::equal("b", 19)},
+                    PredicateCombine::OR, selection));
+    CHECK(selection.countValid(0, selection.size()) == 2);  // la ligne a = 1 est supprimée
+    CHECK(!df.select({ColumnPredicate::equal("missing", 0)}, PredicateCombine::AND, selection));
+
+    std::unique_ptr<CDataframe> copy = df.filter({ColumnPredicate::range("a", 0, 4)});
+    CHECK(dump(*copy) == std::vector<std::string>({"0|10", "2|12", "3|13"}));
+
+    std::unique_ptr<CDataframe> view = df.filter({ColumnPredicate::greater("a", 5)}, PredicateCombine::AND, {}, FilterMode::VIEW);
+    CHECK(view->isView());
+    CHECK(dump(*view) == dump(*df.filter({ColumnPredicate::greater("a", 5)})));
+    CHECK(view->getRowsCount() == 4);
+    CHECK(view->numberOfCellsEqualTo(3) == 0);
+    CHECK(view->numberOfCellsGreaterThan(15) == 4);
+
+    // écrire dans la vue la détache : le tableau d'origine ne change pas
+    CHECK(view->insertRow({int32_t(100), int32_t(200)}));
+    CHECK(!view->isView());
+    CHECK(view->getRowsCount() == 5);
+    CHECK(df.getRowsCount() == 9 && !df.exist(100));
+}
+
+// group-by : le mode PARALLEL (tables partielles fusionnées) donne exactement le résultat SEQUENTIAL
+static void checkGroupBy()
+{
+    // assez de lignes et de threads pour plusieurs tables partielles
+    const unsigned threads = CDataframe::getThreadCount();
+    CDataframe::setThreadCount(4);
+
+    CDataframe df({ColumnType::INT, ColumnType::STRING, ColumnType::DOUBLE});
+    df.setColumnNames({"g", "city", "amount"});
+    std::vector<std::vector<ColumnValue>> batch(3);
+    for (int i = 0; i < 300000; ++i) {
+        batch[0].push_back(int32_t(i % 97));
+        batch[1].push_back(std::string(1, char('A' + (i * 7) % 5)));
+        // valeurs entières : les sommes partielles sont exactes quel que soit l'ordre de fusion
+        batch[2].push_back(i % 31 == 0 ? ColumnValue() : ColumnValue(double(i % 1000)));
+    }
+    CHECK(df.insertRowsColumnar(batch));
+
+    const std::vector<Aggregation> aggregations = {Aggregation::count(), Aggregation::sum("amount"),
+                                                   Aggregation::min("amount"), Aggregation::max("amount"),
+                                                   Aggregation::countDistinct("amount")};
+    std::unique_ptr<CDataframe> sequential = df.groupBy({"g", "city"}).agg(aggregations, GroupByMode::SEQUENTIAL);
+    std::unique_ptr<CDataframe> parallel = df.groupBy({"g", "city"}).agg(aggregations, GroupByMode::PARALLEL);
+    CHECK(sequential && parallel);
+    CHECK(sequential->getRowsCount() == 97 * 5);
+    CHECK(dump(*sequential) == dump(*parallel));
+    CDataframe::setThreadCount(threads);
+
+    // une ligne supprimée n'est dans aucun groupe : même résultat que sans elle
+    CDataframe small({ColumnType::STRING, ColumnType::INT});
+    small.setColumnNames({"city", "v"});
+    CDataframe expected({ColumnType::STRING, ColumnType::INT});
+    expected.setColumnNames({"city", "v"});
+    const std::vector<std::pair<std::string, int>> rows = {{"A", 1}, {"B", 2}, {"A", 3}, {"C", 4}, {"A", 5}};
+    for (size_t i = 0; i < rows.size(); ++i) {
+        small.insertRow({rows[i].first, int32_t(rows[i].second)});
+        if (i != 3) expected.insertRow({rows[i].first, int32_t(rows[i].second)});
+    }
+    small.setDeletionMode(RowDeletionMode::TOMBSTONE);
+    CHECK(small.deleteRow(3));
+    CHECK(small.getDeletedRowsCount() == 1);
+
+    for (GroupByMode mode : {GroupByMode::SEQUENTIAL, GroupByMode::PARALLEL}) {
+        std::unique_ptr<CDataframe> grouped = small.groupBy({"city"}).agg({Aggregation::count(), Aggregation::sum("v")}, mode);
+        CHECK(grouped && grouped->getRowsCount() == 2);  // le groupe C n'avait que la ligne supprimée
+        CHECK(dump(*grouped) == dump(*expected.groupBy({"city"}).agg({Aggregation::count(), Aggregation::sum("v")}, mode)));
+        CHECK(grouped->getColumnByIndex(1)->valueToString(0) == "3");
+    }
+}
+
+// join : clés comparées par valeur (1 == 1.0), NULL ne correspond à rien, NaN correspond à NaN
+static void checkJoin()
+{
+    CDataframe left({ColumnType::INT, ColumnType::INT});
+    left.setColumnNames({"k", "l"});
+    left.insertRow({int32_t(1), int32_t(10)});
+    left.insertRow({int32_t(2), int32_t(20)});
+    left.insertRow({ColumnValue(), int32_t(30)});
+    left.insertRow({int32_t(3), int32_t(40)});
+
+    CDataframe right({ColumnType::DOUBLE, ColumnType::INT});
+    right.setColumnNames({"k2", "r"});
+    const std::vector<ColumnValue> keys = {1.0, 2.5, std::nan(""), ColumnValue(), 3.0, 1.0};
+    for (size_t i = 0; i < keys.size(); ++i) right.insertRow({keys[i], int32_t(100 + i)});
+
+    const std::string null = left.getColumnByName("k")->valueToString(2);
+    CHECK(!left.getColumnByName("k")->getValueAt(2).has_value());
+    CHECK(!right.getColumnByName("k2")->getValueAt(3).has_value());
+
+    for (JoinMode mode : {JoinMode::SEQUENTIAL, JoinMode::PARALLEL}) {
+        std::unique_ptr<CDataframe> inner = left.join(right, "k", "k2", JoinKind::INNER, mode);
+        CHECK(inner && dump(*inner) == std::vector<std::string>({"1|10|100", "1|10|105", "3|40|104"}));
+
+        std::unique_ptr<CDataframe> outer = left.join(right, "k", "k2", JoinKind::LEFT, mode);
+        CHECK(outer && dump(*outer) == std::vector<std::string>({"1|10|100", "1|10|105", "2|20|" + null,
+                                                                  null + "|30|" + null, "3|40|104"}));
+
+        std::unique_ptr<CDataframe> semi = left.join(right, "k", "k2", JoinKind::SEMI, mode);
+        CHECK(semi && dump(*semi) == std::vector<std::string>({"1|10", "3|40"}));
+
+        // dans l'autre sens : la table est construite sur l'autre côté, mêmes paires
+        std::unique_ptr<CDataframe> reversed = right.join(left, "k2", "k", JoinKind::INNER, mode);
+        CHECK(reversed && reversed->getRowsCount() == 3);
+    }
+
+    // NaN face à NaN
+    CDataframe nans({ColumnType::DOUBLE});
+    nans.setColumnNames({"k"});
+    nans.insertRow({std::nan("")});
+    nans.insertRow({2.0});
+    std::unique_ptr<CDataframe> matched = nans.join(right, "k", "k2", JoinKind::INNER);
+    CHECK(matched && matched->getRowsCount() == 1 && matched->getColumnByName("r")->valueToString(0) == "102");
+
+    // une chaîne face à des nombres : types non comparables
+    CDataframe strings({ColumnType::STRING});
+    strings.setColumnNames({"k"});
+    strings.insertRow({std::string("1")});
+    CHECK(strings.join(right, "k", "k2") == nullptr);
+}
+
+// tri multi-clés : NULL en dernier en croissant et en premier en décroissant, clés égales dans l'ordre des lignes
+static void checkSortBy()
+{
+    CDataframe df({ColumnType::INT, ColumnType::STRING, ColumnType::INT});
+    df.setColumnNames({"id", "city", "amount"});
+    const std::vector<std::pair<ColumnValue, ColumnValue>> rows = {
+        {std::string("B"), int32_t(5)}, {std::string("A"), ColumnValue()}, {ColumnValue(), int32_t(3)},
+        {std::string("A"), int32_t(7)}, {std::string("B"), int32_t(5)},    {std::string("A"), int32_t(7)},
+        {ColumnValue(), int32_t(3)},    {std::string("B"), int32_t(1)}};
+    for (size_t i = 0; i < rows.size(); ++i) df.insertRow({int32_t(i), rows[i].first, rows[i].second});
+
+    auto ids = [](CDataframe& sorted) {
+        std::string out;
+        for (int r = 0; r < sorted.getColumnByName("id")->getSize(); ++r) out += sorted.getColumnByName("id")->valueToString(r);
+        return out;
+    };
+
+    std::unique_ptr<CDataframe> sorted = df.sortBy({SortKey::asc("city"), SortKey::desc("amount")});
+    CHECK(sorted && ids(*sorted) == "13504726");
+    sorted = df.sortBy({SortKey::desc("city"), SortKey::asc("amount")}, {"id"});
+    CHECK(sorted && sorted->getColumnsCount() == 1 && ids(*sorted) == "26704351");
+
+    std::vector<size_t> permutation;
+    CHECK(df.sortPermutation({SortKey::asc("city"), SortKey::desc("amount")}, permutation));
+    CHECK(permutation == std::vector<size_t>({1, 3, 5, 0, 4, 7, 2, 6}));
+    CHECK(!df.sortPermutation({SortKey::asc("missing")}, permutation));
+
+    // beaucoup de doublons : comparaison avec un tri stable de référence
+    CDataframe big({ColumnType::INT, ColumnType::INT});
+    big.setColumnNames({"k1", "k2"});
+    std::vector<std::vector<ColumnValue>> batch(2);
+    std::vector<std::pair<std::optional<int>, std::optional<int>>> keys;
+    for (int i = 0; i < 5000; ++i) {
+        const std::optional<int> k1 = i % 13 == 0 ? std::nullopt : std::optional<int>((i * 7919) % 11);
+        const std::optional<int> k2 = i % 17 == 0 ? std::nullopt : std::optional<int>((i * 104729) % 5);
+        batch[0].push_back(k1 ? ColumnValue(int32_t(*k1)) : ColumnValue());
+        batch[1].push_back(k2 ? ColumnValue(int32_t(*k2)) : ColumnValue());
+        keys.push_back({k1, k2});
+    }
+    CHECK(big.insertRowsColumnar(batch));
+
+    // -1 / 0 / 1 : NULL après les valeurs, ordre inversé en décroissant (NULL alors en tête)
+    auto order = [](const std::optional<int>& a, const std::optional<int>& b, bool ascending) {
+        const int cmp = !a && !b ? 0 : !a ? 1 : !b ? -1 : (*a > *b) - (*a < *b);
+        return ascending ? cmp : -cmp;
+    };
+    std::vector<size_t> expected(keys.size());
+    for (size_t i = 0; i < expected.size(); ++i) expected[i] = i;
+    std::stable_sort(expected.begin(), expected.end(), [&](size_t a, size_t b) {
+        const int first = order(keys[a].first, keys[b].first, true);
+        return first != 0 ? first < 0 : order(keys[a].second, keys[b].second, false) < 0;
+    });
+    CHECK(big.sortPermutation({SortKey::asc("k1"), SortKey::desc("k2")}, permutation));
+    CHECK(permutation == expected);
+}
+
+// requêtes paresseuses : collect donne le même tableau que les opérations immédiates enchaînées
+static void checkLazy()
+{
+    CDataframe df({ColumnType::INT, ColumnType::STRING, ColumnType::INT});
+    df.setColumnNames({"year", "city", "amount"});
+    std::vector<std::vector<ColumnValue>> batch(3);
+    for (int i = 0; i < 20000; ++i) {
+        batch[0].push_back(int32_t(2020 + i % 5));
+        batch[1].push_back(i % 23 == 0 ? ColumnValue() : ColumnValue(std::string(1, char('A' + (i * 13) % 7))));
+        batch[2].push_back(i % 11 == 0 ? ColumnValue() : ColumnValue(int32_t((i * 37) % 500)));
+    }
+    CHECK(df.insertRowsColumnar(batch));
+    df.setDeletionMode(RowDeletionMode::TOMBSTONE);
+    CHECK(df.deleteRows({3, 50, 4000}));
+
+    const std::vector<ColumnPredicate> recent = {ColumnPredicate::greater("year", 2021)};
+    const std::vector<ColumnPredicate> large = {ColumnPredicate::greater("amount", 100)};
+
+    // filtre, filtre, projection
+    std::unique_ptr<CDataframe> lazy = df.lazy().filter(recent).filter(large).select({"amount", "city"}).collect();
+    std::unique_ptr<CDataframe> eager = df.filter(recent)->filter(large, PredicateCombine::AND, {"amount", "city"});
+    CHECK(lazy && eager && dump(*lazy) == dump(*eager));
+
+    // filtre puis agrégat puis tri
+    const std::vector<Aggregation> aggregations = {Aggregation::sum("amount"), Aggregation::count()};
+    const std::vector<SortKey> bySum = {SortKey::desc("sum_amount"), SortKey::asc("city")};
+    lazy = df.lazy().filter(large).aggregate({"city"}, aggregations).sortBy(bySum).collect();
+    eager = df.filter(large)->groupBy({"city"}).agg(aggregations)->sortBy(bySum);
+    CHECK(lazy && eager && lazy->getRowsCount() > 0 && dump(*lazy) == dump(*eager));
+
+    // tri, filtre OU, second tri (stable par rapport au premier), projection
+    const std::vector<ColumnPredicate> either = {ColumnPredicate::isNull("city"), ColumnPredicate::lower("amount", 20)};
+    lazy = df.lazy()
+               .sortBy({SortKey::asc("amount")})
+               .filter(either, PredicateCombine::OR)
+               .sortBy({SortKey::desc("year")})
+               .select({"year", "amount"})
+               .collect();
+    eager = df.sortBy({SortKey::asc("amount")})
+                ->filter(either, PredicateCombine::OR)
+                ->sortBy({SortKey::desc("year")}, {"year", "amount"});
+    CHECK(lazy && eager && dump(*lazy) == dump(*eager));
+
+    // plan vide : une copie ; colonne retirée par un select : échec
+    CHECK(dump(*df.lazy().collect()) == dump(df));
+    CHECK(df.lazy().select({"year"}).filter(large).collect() == nullptr);
+}
+
+// statistiques : chaque écriture les tient à jour, les comptages hors des bornes ne lisent aucune ligne
+static void checkStatistics()
+{
+    Column col("x", ColumnType::INT);
+    for (int i = 1; i <= 1000; ++i) col.insertValue(int32_t(i));
+    CHECK(col.hasCurrentStatistics());
+    CHECK(col.numberGreaterThan(5000) == 0);
+    CHECK(col.numberLowerThan(5000) == 1000);
+    CHECK(col.occurence(-3) == 0);
+
+    // un ajout juste avant le comptage : sonde hors des bornes d'avant, réponse des statistiques
+    col.insertValue(int32_t(7000));
+    col.insertValue(std::nullopt);
+    CHECK(col.hasCurrentStatistics());
+    CHECK(col.numberGreaterThan(5000) == 1);
+    CHECK(col.numberLowerThan(8000) == 1001);
+    CHECK(col.numberGreaterThan(500, 0, 600) == 100);
+
+    CHECK(col.insertValuesAuto({ColumnValue(int32_t(-50)), ColumnValue(int32_t(20))}));
+    CHECK(col.hasCurrentStatistics());
+    CHECK(col.numberLowerThan(0) == 1);
+
+    // une suppression à l'intérieur des bornes les garde ; celle d'une borne les laisse à reconstruire
+    CHECK(col.removeValue(10));
+    CHECK(col.hasCurrentStatistics() && col.occurence(11) == 0);
+    CHECK(col.removeValue(999));  // 7000, remontée d'un rang
+    CHECK(!col.hasCurrentStatistics());
+    CHECK(col.numberGreaterThan(5000) == 0);
+    col.refreshStatistics();
+    CHECK(col.hasCurrentStatistics());
+    const ColumnStats& stats = col.getStatistics();
+    CHECK(stats.valueCount() == 1001 && stats.nullCount() == 1);
+    CHECK(stats.maximum() && std::get<int32_t>(*stats.maximum()) == 1000);
+
+    Column names("name", ColumnType::STRING);
+    CHECK(names.insertString("m") && names.insertString("q"));
+    CHECK(names.hasCurrentStatistics() && names.occurence(std::string("z")) == 0);
+
+    // lots insérés par le dataframe
+    CDataframe df = sequenceFrame(100);
+    CHECK(df.insertRowsColumnar({{int32_t(500)}, {int32_t(-5)}}));
+    CHECK(df.getColumnByName("a")->hasCurrentStatistics() && df.getColumnByName("b")->hasCurrentStatistics());
+    CHECK(df.getColumnByName("a")->numberGreaterThan(499) == 1);
+
+    // premier lot d'un dataframe vide : les statistiques du lot sont reprises
+    CDataframe empty({ColumnType::INT});
+    CHECK(empty.insertRowsColumnar({{int32_t(4), ColumnValue(), int32_t(9)}}));
+    const std::shared_ptr<Column> only = empty.getColumnByIndex(0);
+    CHECK(only->hasCurrentStatistics());
+    CHECK(only->numberGreaterThan(9) == 0 && only->numberLowerThan(10) == 2);
+    CHECK(only->getStatistics().nullCount() == 1);
+
+    // un filtre est const : des bornes périmées sont contournées par un parcours complet, pas reconstruites
+    CDataframe stale = sequenceFrame(20);
+    CHECK(stale.deleteRow(19));
+    CHECK(!stale.getColumnByName("a")->hasCurrentStatistics());
+    std::unique_ptr<CDataframe> high = stale.filter({ColumnPredicate::greater("a", 16)});
+    CHECK(dump(*high) == std::vector<std::string>({"17|27", "18|28"}));
+    CHECK(!stale.getColumnByName("a")->hasCurrentStatistics());
+}
+
+int main()
+{
+    checkNaNLookups();
+    checkTombstones();
+    checkSelections();
+    checkGroupBy();
+    checkJoin();
+    checkSortBy();
+    checkLazy();
+    checkStatistics();
+
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "all checks passed\n";
+    return 0;
+}